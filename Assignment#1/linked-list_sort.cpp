@@ -11,9 +11,11 @@ struct Transaction {
     float price;
     string date;
     string paymentMethod;
+    int dateKey;        // parseDate(date), computed once when the node is inserted
     Transaction* next;
 };
 
+// "DD/MM/YYYY" -> YYYYMMDD. Only called once per node; sorts compare dateKey.
 int parseDate(const string& date) {
     int day, month, year;
     char slash;
@@ -24,7 +26,7 @@ int parseDate(const string& date) {
 
 // Insert node at end
 void insert(Transaction*& head, string id, string product, string category, float price, string date, string method) {
-    Transaction* newNode = new Transaction{id, product, category, price, date, method, nullptr};
+    Transaction* newNode = new Transaction{id, product, category, price, date, method, parseDate(date), nullptr};
     if (!head) {
         head = newNode;
         return;
@@ -45,40 +47,70 @@ void printList(Transaction* head) {
 
 // ------- Sorting Algorithms --------
 
-// Merge Sort
-void splitList(Transaction* source, Transaction*& front, Transaction*& back) {
-    Transaction* slow = source;
-    Transaction* fast = source->next;
-    while (fast && fast->next) {
-        slow = slow->next;
-        fast = fast->next->next;
-    }
-    front = source;
-    back = slow->next;
-    slow->next = nullptr;
+// Merge Sort (natural, bottom-up)
+// Detaches the ascending run starting at head and returns the node after it
+Transaction* cutRun(Transaction* head) {
+    while (head->next && head->dateKey <= head->next->dateKey)
+        head = head->next;
+    Transaction* rest = head->next;
+    head->next = nullptr;
+    return rest;
 }
 
-Transaction* merge(Transaction* a, Transaction* b) {
-    if (!a) return b;
-    if (!b) return a;
+// Merges two non-empty sorted lists without recursion; tail gets the last node
+Transaction* merge(Transaction* a, Transaction* b, Transaction*& tail) {
     Transaction* result;
-    if (parseDate(a->date) < parseDate(b->date)) {
-        result = a;
-        result->next = merge(a->next, b);
-    } else {
+    if (b->dateKey < a->dateKey) {
         result = b;
-        result->next = merge(a, b->next);
+        b = b->next;
+    } else {
+        result = a;
+        a = a->next;
+    }
+    tail = result;
+    while (a && b) {
+        if (b->dateKey < a->dateKey) {
+            tail->next = b;
+            b = b->next;
+        } else {
+            tail->next = a;
+            a = a->next;
+        }
+        tail = tail->next;
     }
+    tail->next = a ? a : b;
+    while (tail->next)
+        tail = tail->next;
     return result;
 }
 
+// Each pass merges neighbouring runs pairwise until one run is left.
+// No recursion and O(1) extra space, so long lists cannot overflow the stack.
 void mergeSort(Transaction*& head) {
-    if (!head || !head->next) return;
-    Transaction *a, *b;
-    splitList(head, a, b);
-    mergeSort(a);
-    mergeSort(b);
-    head = merge(a, b);
+    if (!head) return;
+    int runs;
+    do {
+        Transaction* sorted = nullptr;
+        Transaction* sortedTail = nullptr;
+        Transaction* rest = head;
+        runs = 0;
+        while (rest) {
+            Transaction* first = rest;
+            Transaction* second = cutRun(first);
+            Transaction* runHead = first;
+            Transaction* runTail = nullptr;
+            rest = nullptr;
+            if (second) {
+                rest = cutRun(second);
+                runHead = merge(first, second, runTail);
+            }
+            if (sortedTail) sortedTail->next = runHead;
+            else sorted = runHead;
+            sortedTail = runTail;
+            runs++;
+        }
+        head = sorted;
+    } while (runs > 1);
 }
 
 // Insertion Sort
@@ -87,12 +119,12 @@ void insertionSort(Transaction*& head) {
     Transaction* current = head;
     while (current) {
         Transaction* next = current->next;
-        if (!sorted || parseDate(current->date) < parseDate(sorted->date)) {
+        if (!sorted || current->dateKey < sorted->dateKey) {
             current->next = sorted;
             sorted = current;
         } else {
             Transaction* temp = sorted;
-            while (temp->next && parseDate(temp->next->date) <= parseDate(current->date)) {
+            while (temp->next && temp->next->dateKey <= current->dateKey) {
                 temp = temp->next;
             }
             current->next = temp->next;
@@ -104,46 +136,49 @@ void insertionSort(Transaction*& head) {
 }
 
 // Bubble Sort
-void bubbleSort(Transaction* head) {
+// Out-of-order neighbours are swapped by relinking, never by copying fields
+void bubbleSort(Transaction*& head) {
     if (!head) return;
     bool swapped;
-    Transaction* ptr;
+    Transaction* last = nullptr;
     do {
         swapped = false;
-        ptr = head;
-        while (ptr->next) {
-            if (parseDate(ptr->date) > parseDate(ptr->next->date)) {
-                swap(ptr->customerID, ptr->next->customerID);
-                swap(ptr->product, ptr->next->product);
-                swap(ptr->category, ptr->next->category);
-                swap(ptr->price, ptr->next->price);
-                swap(ptr->date, ptr->next->date);
-                swap(ptr->paymentMethod, ptr->next->paymentMethod);
+        Transaction** link = &head;
+        while ((*link)->next != last) {
+            Transaction* a = *link;
+            Transaction* b = a->next;
+            if (a->dateKey > b->dateKey) {
+                a->next = b->next;
+                b->next = a;
+                *link = b;
                 swapped = true;
             }
-            ptr = ptr->next;
+            link = &(*link)->next;
         }
+        last = *link;
     } while (swapped);
 }
 
 // Selection Sort
-void selectionSort(Transaction* head) {
-    for (Transaction* i = head; i && i->next; i = i->next) {
-        Transaction* minNode = i;
-        for (Transaction* j = i->next; j; j = j->next) {
-            if (parseDate(j->date) < parseDate(minNode->date)) {
-                minNode = j;
+// Unlinks the earliest remaining node and appends it to the sorted list
+void selectionSort(Transaction*& head) {
+    Transaction* sorted = nullptr;
+    Transaction* sortedTail = nullptr;
+    while (head) {
+        Transaction** minLink = &head;
+        for (Transaction** link = &head->next; *link; link = &(*link)->next) {
+            if ((*link)->dateKey < (*minLink)->dateKey) {
+                minLink = link;
             }
         }
-        if (minNode != i) {
-            swap(i->customerID, minNode->customerID);
-            swap(i->product, minNode->product);
-            swap(i->category, minNode->category);
-            swap(i->price, minNode->price);
-            swap(i->date, minNode->date);
-            swap(i->paymentMethod, minNode->paymentMethod);
-        }
+        Transaction* minNode = *minLink;
+        *minLink = minNode->next;
+        minNode->next = nullptr;
+        if (sortedTail) sortedTail->next = minNode;
+        else sorted = minNode;
+        sortedTail = minNode;
     }
+    head = sorted;
 }
 
 // --------- Main Program ----------
@@ -1,6 +1,13 @@
 #include <iostream>
 #include <cmath>
 #include <string>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
 using namespace std;
 
 // ---------- Transaction & Node Structures ----------
@@ -21,62 +28,147 @@ struct Node {
 
 // ---------- Linked List ----------
 class LinkedList {
+private:
+    Node* tail;
+    int length;
+    // Bumped by every change to the list; the node index is rebuilt when it moves
+    unsigned long modCount;
+
+    // Cached random-access index: nodes in list order
+    mutable Node** index;
+    mutable int indexCapacity;
+    mutable unsigned long indexModCount;
+    mutable bool indexBuilt;
+
+    // (category, payment) -> number of transactions. Built by the first
+    // pairCount() call, then kept current by insert(); sorts don't change it.
+    mutable unordered_map<string, int> pairCounts;
+    mutable bool pairCountsBuilt;
+
+    static string pairKey(const string& category, const string& payment) {
+        return category + '\x1f' + payment;
+    }
+
+    void updateTail() {
+        tail = head;
+        while (tail && tail->next) tail = tail->next;
+    }
+
 public:
     Node* head;
-    LinkedList() : head(nullptr) {}
+    LinkedList() : tail(nullptr), length(0), modCount(0), index(nullptr), indexCapacity(0),
+                   indexModCount(0), indexBuilt(false), pairCountsBuilt(false), head(nullptr) {}
+
+    ~LinkedList() {
+        while (head) {
+            Node* next = head->next;
+            delete head;
+            head = next;
+        }
+        delete[] index;
+    }
+
+    // Owns its nodes and index, so copies would free them twice
+    LinkedList(const LinkedList&) = delete;
+    LinkedList& operator=(const LinkedList&) = delete;
 
     void insert(Transaction t) {
         Node* newNode = new Node(t);
         if (!head) head = newNode;
-        else {
-            Node* temp = head;
-            while (temp->next) temp = temp->next;
-            temp->next = newNode;
+        else tail->next = newNode;
+        tail = newNode;
+        length++;
+        modCount++;
+        if (pairCountsBuilt) pairCounts[pairKey(t.category, t.paymentMethod)]++;
+    }
+
+    // Transactions with this category and payment method, O(1) after the first call
+    int pairCount(const string& category, const string& payment) const {
+        if (!pairCountsBuilt) {
+            for (Node* temp = head; temp; temp = temp->next)
+                pairCounts[pairKey(temp->data.category, temp->data.paymentMethod)]++;
+            pairCountsBuilt = true;
         }
+        auto it = pairCounts.find(pairKey(category, payment));
+        return it == pairCounts.end() ? 0 : it->second;
     }
 
     int getLength() const {
-        int count = 0;
-        Node* temp = head;
-        while (temp) {
-            count++;
-            temp = temp->next;
+        return length;
+    }
+
+    // Nodes in list order, rebuilt only if the list changed since the last call.
+    // The array belongs to the list and is valid until the next modification.
+    Node* const* nodeIndex(int& len) const {
+        if (!indexBuilt || indexModCount != modCount) {
+            if (indexCapacity < length) {
+                delete[] index;
+                indexCapacity = length;
+                index = new Node*[indexCapacity];
+            }
+            Node* temp = head;
+            for (int i = 0; i < length; ++i) {
+                index[i] = temp;
+                temp = temp->next;
+            }
+            indexModCount = modCount;
+            indexBuilt = true;
         }
-        return count;
+        len = length;
+        return index;
     }
 
     void sortByCategory() {
         if (!head || !head->next) return;
         bool swapped;
+        Node* last = nullptr;
         do {
             swapped = false;
-            Node* curr = head;
-            while (curr->next) {
-                if (curr->data.category > curr->next->data.category) {
-                    swap(curr->data, curr->next->data);
+            Node** link = &head;
+            while ((*link)->next != last) {
+                Node* curr = *link;
+                Node* next = curr->next;
+                if (curr->data.category > next->data.category) {
+                    // Relink the two nodes instead of swapping their records
+                    curr->next = next->next;
+                    next->next = curr;
+                    *link = next;
                     swapped = true;
                 }
-                curr = curr->next;
+                link = &(*link)->next;
             }
+            last = *link;
         } while (swapped);
+        updateTail();
+        modCount++;
     }
 
     void sortByPrice() {
         if (!head || !head->next) return;
         bool swapped;
+        Node* last = nullptr;
         do {
             swapped = false;
-            Node* curr = head;
-            while (curr->next) {
-                if (curr->data.price > curr->next->data.price) {
-                    swap(curr->data, curr->next->data);
+            Node** link = &head;
+            while ((*link)->next != last) {
+                Node* curr = *link;
+                Node* next = curr->next;
+                if (curr->data.price > next->data.price) {
+                    // Relink the two nodes instead of swapping their records
+                    curr->next = next->next;
+                    next->next = curr;
+                    *link = next;
                     swapped = true;
                 }
-                curr = curr->next;
+                link = &(*link)->next;
             }
+            last = *link;
         } while (swapped);
+        updateTail();
+        modCount++;
     }
 
+    // Fresh caller-owned copy of the node pointers (O(n) per call)
     Node** toArray(int& length) const {
         length = getLength();
         Node** arr = new Node*[length];
@@ -106,7 +198,7 @@ public:
     // 2. Binary Search (needs sorted list by category)
     static int binarySearch(const LinkedList& list, const string& category, const string& payment) {
         int len = 0;
-        Node** arr = list.toArray(len);
+        Node* const* arr = list.nodeIndex(len);
         int count = 0;
         int low = 0, high = len - 1;
 
@@ -124,7 +216,6 @@ public:
                     if (arr[i]->data.paymentMethod == payment) count++;
                     i++;
                 }
-                delete[] arr;
                 return count;
             } else if (arr[mid]->data.category < category)
                 low = mid + 1;
@@ -132,7 +223,6 @@ public:
                 high = mid - 1;
         }
 
-        delete[] arr;
         return count;
     }
 
@@ -167,7 +257,7 @@ public:
     // 4. Interpolation Search (adapted for price)
     static Node* interpolationSearchByPrice(const LinkedList& list, double targetPrice) {
         int len = 0;
-        Node** arr = list.toArray(len);
+        Node* const* arr = list.nodeIndex(len);
         int low = 0, high = len - 1;
 
         while (low <= high &&
@@ -185,11 +275,8 @@ public:
 
             double currentPrice = arr[pos]->data.price;
 
-            if (currentPrice == targetPrice) {
-                Node* result = arr[pos];
-                delete[] arr;
-                return result;
-            }
+            if (currentPrice == targetPrice)
+                return arr[pos];
 
             if (currentPrice < targetPrice)
                 low = pos + 1;
@@ -197,13 +284,109 @@ public:
                 high = pos - 1;
         }
 
-        delete[] arr;
         return nullptr;
     }
+
+    // 5. Hash Table lookup (any order; the searches above are kept as baselines)
+    static int hashLookup(const LinkedList& list, const string& category, const string& payment) {
+        return list.pairCount(category, payment);
+    }
 };
 
+// ---------- Benchmark ----------
+// Amortized cost per query of binary and interpolation search on n nodes:
+// copying the list with toArray() before each query (the old behaviour)
+// against the cached node index. The cached runs go first, so their totals
+// include the one index build.
+void runSearchBenchmark(int n) {
+    const int QUERIES = 10000;
+    const int COPY_QUERIES = 100;   // a copy per query is O(n), so fewer of these
+    const string payments[] = {"Cash", "Credit Card", "Debit Card", "PayPal"};
+    mt19937 rng(42);
+
+    // Generated in sorted order, so the O(n^2) bubble sorts are not needed
+    LinkedList byCategory, byPrice;
+    for (int i = 0; i < n; i++) {
+        char category[16];
+        snprintf(category, sizeof(category), "CAT%07d", i / 16);
+        byCategory.insert({"C" + to_string(i), "Item", 0.0, "2024-01-01", category, payments[rng() % 4]});
+        byPrice.insert({"C" + to_string(i), "Item", i * 0.5, "2024-01-01", "Electronics", payments[rng() % 4]});
+    }
+    vector<string> categoryQueries(QUERIES);
+    vector<double> priceQueries(QUERIES);
+    for (int q = 0; q < QUERIES; q++) {
+        char category[16];
+        snprintf(category, sizeof(category), "CAT%07d", (int)(rng() % n) / 16);
+        categoryQueries[q] = category;
+        priceQueries[q] = (rng() % n) * 0.5;
+    }
+
+    auto usPerQuery = [](chrono::high_resolution_clock::time_point start, int queries) {
+        return chrono::duration<double, micro>(chrono::high_resolution_clock::now() - start).count() / queries;
+    };
+    // Hit counts go to sink at the end, so the timed lookups can't be optimized away
+    long long found = 0;
+    volatile long long sink = 0;
+
+    auto start = chrono::high_resolution_clock::now();
+    for (int q = 0; q < QUERIES; q++)
+        found += LinkedListSearch::binarySearch(byCategory, categoryQueries[q], "Credit Card");
+    double binaryCached = usPerQuery(start, QUERIES);
+    start = chrono::high_resolution_clock::now();
+    for (int q = 0; q < COPY_QUERIES; q++) {
+        int len = 0;
+        Node** arr = byCategory.toArray(len);
+        delete[] arr;
+        found += LinkedListSearch::binarySearch(byCategory, categoryQueries[q], "Credit Card");
+    }
+    double binaryCopy = usPerQuery(start, COPY_QUERIES);
+
+    start = chrono::high_resolution_clock::now();
+    for (int q = 0; q < QUERIES; q++)
+        found += LinkedListSearch::interpolationSearchByPrice(byPrice, priceQueries[q]) != nullptr;
+    double interpolationCached = usPerQuery(start, QUERIES);
+    start = chrono::high_resolution_clock::now();
+    for (int q = 0; q < COPY_QUERIES; q++) {
+        int len = 0;
+        Node** arr = byPrice.toArray(len);
+        delete[] arr;
+        found += LinkedListSearch::interpolationSearchByPrice(byPrice, priceQueries[q]) != nullptr;
+    }
+    double interpolationCopy = usPerQuery(start, COPY_QUERIES);
+
+    // A report asks for PAIRS (category, payment) counts
+    const int PAIRS = 48;
+    vector<pair<string, string>> report;
+    for (int p = 0; p < PAIRS; p++) report.push_back({categoryQueries[p], payments[rng() % 4]});
+    auto msPerReport = [&](int (*count)(const LinkedList&, const string&, const string&)) {
+        auto reportStart = chrono::high_resolution_clock::now();
+        for (const auto& query : report) found += count(byCategory, query.first, query.second);
+        return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - reportStart).count();
+    };
+    double linearReport = msPerReport([](const LinkedList& l, const string& c, const string& p) {
+        return LinkedListSearch::linearSearch(l.head, c, p);
+    });
+    double jumpReport = msPerReport([](const LinkedList& l, const string& c, const string& p) {
+        return LinkedListSearch::jumpSearch(l.head, c, p);
+    });
+    double binaryReport = msPerReport(LinkedListSearch::binarySearch);
+    double hashFirstReport = msPerReport(LinkedListSearch::hashLookup);   // includes the table build
+    double hashReport = msPerReport(LinkedListSearch::hashLookup);
+
+    cout << "\n===== Search Benchmark: " << n << " nodes (us per query) =====" << endl;
+    cout << "Binary Search:        copy per query " << binaryCopy
+         << ", cached index " << binaryCached << " (amortized over " << QUERIES << ")" << endl;
+    cout << "Interpolation Search: copy per query " << interpolationCopy
+         << ", cached index " << interpolationCached << " (amortized over " << QUERIES << ")" << endl;
+    cout << "Report of " << PAIRS << " (category, payment) counts, ms: linear " << linearReport
+         << ", jump " << jumpReport << ", binary " << binaryReport << ", hash table " << hashReport
+         << " (first report, with build: " << hashFirstReport << ")" << endl;
+    sink = sink + found;
+}
+
 // ---------- Main (Testing with Dummy Data) ----------
-int main() {
+// Usage: ./linked_list_search_requirement [--bench N]
+int main(int argc, char* argv[]) {
     LinkedList list;
 
     // Dummy data for testing
@@ -229,6 +412,9 @@ int main() {
     cout << "Jump Search result:         "
          << LinkedListSearch::jumpSearch(list.head, category, payment) << endl;
 
+    cout << "Hash Table result:          "
+         << LinkedListSearch::hashLookup(list, category, payment) << endl;
+
     list.sortByPrice();
     double searchPrice = 299.99;
     Node* found = LinkedListSearch::interpolationSearchByPrice(list, searchPrice);
@@ -238,6 +424,10 @@ int main() {
     else
         cout << "Interpolation Search result: Price not found." << endl;
 
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--bench") == 0) runSearchBenchmark(atoi(argv[i + 1]));
+    }
+
     return 0;
 }
 
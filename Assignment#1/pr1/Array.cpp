@@ -1,4 +1,5 @@
 #include "Array.hpp"
+#include "datastore.hpp"
 #include <fstream>
 #include <sstream>
 #include <cctype>
@@ -7,16 +8,38 @@
 #include <chrono>
 #include <algorithm>
 #include <iomanip>
+#include <cstdlib>
 
 Array::Array(int initial_capacity) : trans_capacity(initial_capacity), trans_size(0),
-                                     rev_capacity(initial_capacity), rev_size(0) {
+                                     rev_capacity(initial_capacity), rev_size(0),
+                                     scan_threads(1), scan_pool(nullptr),
+                                     category_index_valid(false), date_index_valid(false),
+                                     rating_index_valid(false), review_index_valid(false) {
     transactions = new Transaction[trans_capacity];
     reviews = new Review[rev_capacity];
+    unsigned hw = std::thread::hardware_concurrency();
+    if (hw > 0) scan_threads = static_cast<int>(hw);
 }
 
 Array::~Array() {
     delete[] transactions;
     delete[] reviews;
+    delete scan_pool;
+}
+
+void Array::setScanThreads(int threads) {
+    if (threads < 1) threads = 1;
+    if (threads == scan_threads) return;
+    scan_threads = threads;
+    delete scan_pool;
+    scan_pool = nullptr;
+}
+
+int Array::getScanThreads() const { return scan_threads; }
+
+ScanThreadPool& Array::scanPool() {
+    if (scan_pool == nullptr) scan_pool = new ScanThreadPool(scan_threads);
+    return *scan_pool;
 }
 
 void Array::resizeTransactions() {
@@ -35,12 +58,36 @@ void Array::resizeReviews() {
     reviews = new_array;
 }
 
+void Array::invalidateTransactionIndexes() {
+    category_index_valid = false;
+    date_index_valid = false;
+}
+
+void Array::invalidateReviewIndexes() {
+    rating_index_valid = false;
+    review_index_valid = false;
+}
+
+void Array::buildReviewIndex() {
+    review_index.build(rev_size,
+                       [&](int i) -> const std::string& { return reviews[i].review_text; },
+                       [&](int i) { return reviews[i].rating; });
+    review_index_valid = true;
+}
+
+const ReviewIndex& Array::reviewIndex() {
+    if (!review_index_valid) buildReviewIndex();
+    return review_index;
+}
+
 void Array::addTransaction(const Transaction& t) {
+    invalidateTransactionIndexes();
     if (trans_size == trans_capacity) resizeTransactions();
     transactions[trans_size++] = t;
 }
 
 void Array::addReview(const Review& r) {
+    invalidateReviewIndexes();
     if (rev_size == rev_capacity) resizeReviews();
     reviews[rev_size++] = r;
 }
@@ -59,10 +106,8 @@ int Array::getTransSize() const { return trans_size; }
 int Array::getRevSize() const { return rev_size; }
 
 int Array::linearSearchByCategory(const std::string& category) {
-    for (int i = 0; i < trans_size; i++) {
-        if (transactions[i].category == category) return i;
-    }
-    return -1;
+    return parallelFindFirst(scanPool(), trans_size,
+                             [&](int i) { return transactions[i].category == category; });
 }
 
 int Array::binarySearchByCategory(const std::string& category) {
@@ -102,6 +147,27 @@ int Array::interpolationSearchByCategory(const std::string& category) {
     return -1;
 }
 
+// S-tree searches return the first matching row. The index is built over the
+// current order on first use, so the data must already be sorted by that key.
+int Array::sTreeSearchByCategory(const std::string& category) {
+    if (!category_index_valid) {
+        category_index.build(trans_size, [&](int i) -> const std::string& { return transactions[i].category; });
+        category_index_valid = true;
+    }
+    int idx = category_index.lowerBound(category);
+    return (idx < trans_size && transactions[idx].category == category) ? idx : -1;
+}
+
+int Array::sTreeLowerBoundByDate(int date_key) {
+    if (!date_index_valid) {
+        std::vector<int> keys(trans_size);
+        for (int i = 0; i < trans_size; i++) keys[i] = transactions[i].date_key;
+        date_index.build(keys.data(), trans_size);
+        date_index_valid = true;
+    }
+    return date_index.lowerBound(date_key);
+}
+
 int Array::linearSearchByRating(int rating) {
     for (int i = 0; i < rev_size; i++) {
         if (reviews[i].rating == rating) return i;
@@ -147,7 +213,19 @@ int Array::interpolationSearchByRating(int rating) {
     return -1;
 }
 
+int Array::sTreeSearchByRating(int rating) {
+    if (!rating_index_valid) {
+        std::vector<int> keys(rev_size);
+        for (int i = 0; i < rev_size; i++) keys[i] = reviews[i].rating;
+        rating_index.build(keys.data(), rev_size);
+        rating_index_valid = true;
+    }
+    int idx = rating_index.lowerBound(rating);
+    return (idx < rev_size && reviews[idx].rating == rating) ? idx : -1;
+}
+
 void Array::bubbleSortByCategory() {
+    invalidateTransactionIndexes();
     for (int i = 0; i < trans_size - 1; i++) {
         for (int j = 0; j < trans_size - i - 1; j++) {
             if (transactions[j].category > transactions[j + 1].category) {
@@ -158,6 +236,7 @@ void Array::bubbleSortByCategory() {
 }
 
 void Array::insertionSortByCategory() {
+    invalidateTransactionIndexes();
     for (int i = 1; i < trans_size; i++) {
         Transaction key = transactions[i];
         int j = i - 1;
@@ -170,6 +249,7 @@ void Array::insertionSortByCategory() {
 }
 
 void Array::selectionSortByCategory() {
+    invalidateTransactionIndexes();
     for (int i = 0; i < trans_size - 1; i++) {
         int min_idx = i;
         for (int j = i + 1; j < trans_size; j++) {
@@ -180,13 +260,15 @@ void Array::selectionSortByCategory() {
 }
 
 void Array::mergeSortByCategory() {
+    invalidateTransactionIndexes();
     if (trans_size > 1) mergeSortHelper(0, trans_size - 1, true);
 }
 
 void Array::bubbleSortByDate() {
+    invalidateTransactionIndexes();
     for (int i = 0; i < trans_size - 1; i++) {
         for (int j = 0; j < trans_size - i - 1; j++) {
-            if (transactions[j].date > transactions[j + 1].date) {
+            if (transactions[j].date_key > transactions[j + 1].date_key) {
                 std::swap(transactions[j], transactions[j + 1]);
             }
         }
@@ -194,10 +276,11 @@ void Array::bubbleSortByDate() {
 }
 
 void Array::insertionSortByDate() {
+    invalidateTransactionIndexes();
     for (int i = 1; i < trans_size; i++) {
         Transaction key = transactions[i];
         int j = i - 1;
-        while (j >= 0 && transactions[j].date > key.date) {
+        while (j >= 0 && transactions[j].date_key > key.date_key) {
             transactions[j + 1] = transactions[j];
             j--;
         }
@@ -206,20 +289,23 @@ void Array::insertionSortByDate() {
 }
 
 void Array::selectionSortByDate() {
+    invalidateTransactionIndexes();
     for (int i = 0; i < trans_size - 1; i++) {
         int min_idx = i;
         for (int j = i + 1; j < trans_size; j++) {
-            if (transactions[j].date < transactions[min_idx].date) min_idx = j;
+            if (transactions[j].date_key < transactions[min_idx].date_key) min_idx = j;
         }
         if (min_idx != i) std::swap(transactions[i], transactions[min_idx]);
     }
 }
 
 void Array::mergeSortByDate() {
+    invalidateTransactionIndexes();
     if (trans_size > 1) mergeSortHelper(0, trans_size - 1, false);
 }
 
 void Array::bubbleSortByRating() {
+    invalidateReviewIndexes();
     for (int i = 0; i < rev_size - 1; i++) {
         for (int j = 0; j < rev_size - i - 1; j++) {
             if (reviews[j].rating > reviews[j + 1].rating) {
@@ -230,6 +316,7 @@ void Array::bubbleSortByRating() {
 }
 
 void Array::mergeSortByRating() {
+    invalidateReviewIndexes();
     if (rev_size > 1) mergeSortReviewsHelper(0, rev_size - 1);
 }
 
@@ -246,7 +333,7 @@ void Array::merge(int left, int mid, int right, bool by_category) {
             if (L[i].category <= R[j].category) transactions[k++] = L[i++];
             else transactions[k++] = R[j++];
         } else {
-            if (L[i].date <= R[j].date) transactions[k++] = L[i++];
+            if (L[i].date_key <= R[j].date_key) transactions[k++] = L[i++];
             else transactions[k++] = R[j++];
         }
     }
@@ -292,503 +379,276 @@ void Array::mergeSortReviewsHelper(int left, int right) {
     }
 }
 
-void Array::displaySampleTransactions(const Array& arr, int count) {
-    std::cout << "\nSample Sorted Transactions:\n";
-    std::cout << std::left << std::setw(12) << "Date"
-              << " | " << std::setw(12) << "CustomerID"
-              << " | " << std::setw(20) << "Product"
-              << " | " << std::setw(10) << "Category"
-              << " | " << "Price" << std::endl;
-    std::cout << std::string(75, '-') << std::endl;
-
-    for (int i = 0; i < count && i < arr.getTransSize(); ++i) {
-        Transaction t = arr.getTransaction(i);
-        std::cout << std::setw(12) << t.date << " | "
-                  << std::setw(12) << t.customer_id << " | "
-                  << std::setw(20) << t.product << " | "
-                  << std::setw(10) << t.category << " | "
-                  << std::fixed << std::setprecision(2) << t.price << std::endl;
+// The searches that need order sort first and then walk the run of the
+// category around the row they find.
+int Array::countCategoryAndPayment(const std::string& category, const std::string& payment,
+                                   int& category_count, int& payment_count, int search_choice, int sort_choice) {
+    category_count = 0;
+    payment_count = 0;
+    if (search_choice < 2 || search_choice > 5) {
+        // Linear search does not need sorted data, so it runs as a parallel scan over all rows
+        ScanThreadPool& pool = scanPool();
+        int chunks = scanChunkCount(pool, trans_size);
+        std::vector<int> category_partial(chunks, 0);
+        std::vector<int> payment_partial(chunks, 0);
+        parallelForChunks(pool, trans_size, chunks, [&](int chunk, int begin, int end) {
+            int in_category = 0, with_payment = 0;
+            for (int i = begin; i < end; i++) {
+                if (transactions[i].category == category) {
+                    in_category++;
+                    if (transactions[i].payment_method == payment) with_payment++;
+                }
+            }
+            category_partial[chunk] = in_category;
+            payment_partial[chunk] = with_payment;
+        });
+        for (int c = 0; c < chunks; c++) {
+            category_count += category_partial[c];
+            payment_count += payment_partial[c];
+        }
+        return 1;
     }
-}
 
-void Array::sortTransactionsByDate(int sort_choice, long long& duration_ms) {
-    auto start = std::chrono::high_resolution_clock::now();
-    switch (sort_choice) {
-        case 1:
-            bubbleSortByDate();
-            std::cout << "[Bubble Sort] ";
-            break;
-        case 2:
-            insertionSortByDate();
-            std::cout << "[Insertion Sort] ";
-            break;
-        case 3:
-            selectionSortByDate();
-            std::cout << "[Selection Sort] ";
-            break;
-        case 4:
-            mergeSortByDate();
-            std::cout << "[Merge Sort] ";
-            break;
-        default:
-            std::cout << "Invalid sort choice. Using Merge Sort.\n";
-            mergeSortByDate();
-            std::cout << "[Merge Sort] ";
-            break;
+    if (sort_choice == 1) bubbleSortByCategory();
+    else if (sort_choice == 2) insertionSortByCategory();
+    else if (sort_choice == 3) selectionSortByCategory();
+    else mergeSortByCategory();
+
+    int idx;
+    if (search_choice == 2) idx = binarySearchByCategory(category);
+    else if (search_choice == 3) idx = jumpSearchByCategory(category);
+    else if (search_choice == 4) idx = interpolationSearchByCategory(category);
+    else idx = sTreeSearchByCategory(category);
+    if (idx == -1) return search_choice;
+    while (idx > 0 && transactions[idx - 1].category == category) idx--;
+    for (int i = idx; i < trans_size && transactions[i].category == category; i++) {
+        category_count++;
+        if (transactions[i].payment_method == payment) payment_count++;
     }
-    auto end = std::chrono::high_resolution_clock::now();
-    duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-
-    std::cout << "Execution time: " << duration_ms << " ms\n";
-    std::cout << "Total transactions: " << trans_size << "\n";
-    std::cout << "Total reviews: " << rev_size << "\n";
-    displaySampleTransactions(*this);
+    return search_choice;
 }
 
-double Array::calculateElectronicsCreditCardPercentage(int search_choice, int sort_choice, long long& duration_ms) {
-    auto start = std::chrono::high_resolution_clock::now();
-    int electronics_count = 0;
-    int credit_card_count = 0;
-
-    if (sort_choice == 1) {
-        bubbleSortByCategory();
-        std::cout << "[Bubble Sort] ";
-    } else if (sort_choice == 2) {
-        insertionSortByCategory();
-        std::cout << "[Insertion Sort] ";
-    } else if (sort_choice == 3) {
-        selectionSortByCategory();
-        std::cout << "[Selection Sort] ";
-    } else {
-        mergeSortByCategory();
-        std::cout << "[Merge Sort] ";
-    }
-
-    if (search_choice == 1) {
-        std::cout << "[Linear Search] ";
-        for (int i = 0; i < trans_size; i++) {
-            if (transactions[i].category == "electronics") {
-                electronics_count++;
-                if (transactions[i].payment_method == "credit card") credit_card_count++;
-            }
-        }
-    } else if (search_choice == 2) {
-        std::cout << "[Binary Search] ";
-        int idx = binarySearchByCategory("electronics");
-        if (idx != -1) {
-            for (int i = idx; i >= 0 && transactions[i].category == "electronics"; i--) {
-                electronics_count++;
-                if (transactions[i].payment_method == "credit card") credit_card_count++;
-            }
-            for (int i = idx + 1; i < trans_size && transactions[i].category == "electronics"; i++) {
-                electronics_count++;
-                if (transactions[i].payment_method == "credit card") credit_card_count++;
-            }
-        }
-    } else if (search_choice == 3) {
-        std::cout << "[Jump Search] ";
-        int idx = jumpSearchByCategory("electronics");
-        if (idx != -1) {
-            for (int i = idx; i >= 0 && transactions[i].category == "electronics"; i--) {
-                electronics_count++;
-                if (transactions[i].payment_method == "credit card") credit_card_count++;
-            }
-            for (int i = idx + 1; i < trans_size && transactions[i].category == "electronics"; i++) {
-                electronics_count++;
-                if (transactions[i].payment_method == "credit card") credit_card_count++;
-            }
-        }
-    } else if (search_choice == 4) {
-        std::cout << "[Interpolation Search] ";
-        int idx = interpolationSearchByCategory("electronics");
-        if (idx != -1) {
-            for (int i = idx; i >= 0 && transactions[i].category == "electronics"; i--) {
-                electronics_count++;
-                if (transactions[i].payment_method == "credit card") credit_card_count++;
-            }
-            for (int i = idx + 1; i < trans_size && transactions[i].category == "electronics"; i++) {
-                electronics_count++;
-                if (transactions[i].payment_method == "credit card") credit_card_count++;
-            }
-        }
-    } else {
-        std::cout << "Invalid search choice. Using Linear Search.\n";
-        std::cout << "[Linear Search] ";
-        for (int i = 0; i < trans_size; i++) {
-            if (transactions[i].category == "electronics") {
-                electronics_count++;
-                if (transactions[i].payment_method == "credit card") credit_card_count++;
-            }
+int Array::countWordsByRating(int rating, std::vector<WordFrequency>& words, int search_choice) {
+    if (search_choice < 2 || search_choice > 5) {
+        const ReviewIndex& index = reviewIndex();
+        for (int id = 0; id < index.termCount(); id++) {
+            int count = index.occurrencesAt(id, rating);
+            if (count > 0) words.push_back(WordFrequency{index.termAt(id), count});
         }
+        return 1;
     }
 
-    auto end = std::chrono::high_resolution_clock::now();
-    duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    mergeSortByRating();
+    int idx;
+    if (search_choice == 2) idx = binarySearchByRating(rating);
+    else if (search_choice == 3) idx = jumpSearchByRating(rating);
+    else if (search_choice == 4) idx = interpolationSearchByRating(rating);
+    else idx = sTreeSearchByRating(rating);
+    if (idx == -1) return search_choice;
+    while (idx > 0 && reviews[idx - 1].rating == rating) idx--;
+    std::unordered_map<std::string, int> counts;
+    for (int i = idx; i < rev_size && reviews[i].rating == rating; i++) {
+        forEachWord(reviews[i].review_text, [&](const std::string& word) { counts[word]++; });
+    }
+    for (const auto& entry : counts) words.push_back(WordFrequency{entry.first, entry.second});
+    return search_choice;
+}
 
-    double percentage = electronics_count > 0 ? (static_cast<double>(credit_card_count) / electronics_count * 100.0) : 0.0;
-    std::cout << "Execution time: " << duration_ms << " ms\n";
-    std::cout << "Total Electronics Purchases: " << electronics_count << "\n";
-    std::cout << "Electronics Purchases with Credit Card: " << credit_card_count << "\n";
-    std::cout << "Percentage: " << std::fixed << std::setprecision(2) << percentage << "%\n";
-    return percentage;
-}
-
-// void Array::findFrequentWordsInOneStarReviews(int search_choice, long long& duration_ms) {
-//     auto start = std::chrono::high_resolution_clock::now();
-//     const int MAX_WORDS = 1000;
-//     WordFrequency word_freq[MAX_WORDS];
-//     int word_count = 0;
-
-//     if (search_choice >= 2) {
-//         mergeSortByRating();
-//     }
-
-//     auto splitWords = [](const std::string& text, std::string* words, int& num_words) {
-//         std::string word;
-//         num_words = 0;
-//         for (char c : text) {
-//             if (std::isalnum(c)) word += std::tolower(c);
-//             else if (!word.empty()) {
-//                 words[num_words++] = word;
-//                 word.clear();
-//             }
-//         }
-//         if (!word.empty()) words[num_words++] = word;
-//     };
-
-//     std::string words[100];
-//     int num_words;
-
-//     if (search_choice == 1) {
-//         std::cout << "[Linear Search] ";
-//         for (int i = 0; i < rev_size; i++) {
-//             if (reviews[i].rating == 1) {
-//                 splitWords(reviews[i].review_text, words, num_words);
-//                 for (int j = 0; j < num_words; j++) {
-//                     std::string word = words[j];
-//                     bool found = false;
-//                     for (int k = 0; k < word_count; k++) {
-//                         if (word_freq[k].word == word) {
-//                             word_freq[k].count++;
-//                             found = true;
-//                             break;
-//                         }
-//                     }
-//                     if (!found && word_count < MAX_WORDS) {
-//                         word_freq[word_count].word = word;
-//                         word_freq[word_count].count = 1;
-//                         word_count++;
-//                     }
-//                 }
-//             }
-//         }
-//     } else {
-//         std::cout << (search_choice == 2 ? "[Binary Search] " : search_choice == 3 ? "[Jump Search] " : "[Interpolation Search] ");
-//         int idx = (search_choice == 2 ? binarySearchByRating(1) :
-//                    search_choice == 3 ? jumpSearchByRating(1) :
-//                    interpolationSearchByRating(1));
-//         if (idx != -1) {
-//             for (int i = idx; i >= 0 && reviews[i].rating == 1; i--) {
-//                 splitWords(reviews[i].review_text, words, num_words);
-//                 for (int j = 0; j < num_words; j++) {
-//                     std::string word = words[j];
-//                     bool found = false;
-//                     for (int k = 0; k < word_count; k++) {
-//                         if (word_freq[k].word == word) {
-//                             word_freq[k].count++;
-//                             found = true;
-//                             break;
-//                         }
-//                     }
-//                     if (!found && word_count < MAX_WORDS) {
-//                         word_freq[word_count].word = word;
-//                         word_freq[word_count].count = 1;
-//                         word_count++;
-//                     }
-//                 }
-//             }
-//             for (int i = idx + 1; i < rev_size && reviews[i].rating == 1; i++) {
-//                 splitWords(reviews[i].review_text, words, num_words);
-//                 for (int j = 0; j < num_words; j++) {
-//                     std::string word = words[j];
-//                     bool found = false;
-//                     for (int k = 0; k < word_count; k++) {
-//                         if (word_freq[k].word == word) {
-//                             word_freq[k].count++;
-//                             found = true;
-//                             break;
-//                         }
-//                     }
-//                     if (!found && word_count < MAX_WORDS) {
-//                         word_freq[word_count].word = word;
-//                         word_freq[word_count].count = 1;
-//                         word_count++;
-//                     }
-//                 }
-//             }
-//         }
-//     }
-
-//     for (int i = 1; i < word_count; i++) {
-//         WordFrequency key = word_freq[i];
-//         int j = i - 1;
-//         while (j >= 0 && word_freq[j].count < key.count) {
-//             word_freq[j + 1] = word_freq[j];
-//             j--;
-//         }
-//         word_freq[j + 1] = key;
-//     }
-
-//     auto end = std::chrono::high_resolution_clock::now();
-//     duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-
-//     int top_n = 5;
-//     if (word_count < top_n) top_n = word_count;
-//     std::cout << "Execution time: " << duration_ms << " ms\n";
-//     std::cout << "Top " << top_n << " frequent words in 1-star reviews:\n";
-//     for (int i = 0; i < top_n; i++) {
-//         std::cout << word_freq[i].word << ": " << word_freq[i].count << "\n";
-//     }
-// }
-
-
-
-
-// Question 3: Find Frequent Words in 1-Star Reviews with Sorting Choice
-void Array::findFrequentWordsInOneStarReviews(int sort_choice, long long& duration_ms) {
+// Question 4: price statistics over all transactions and per category.
+// Prices are copied into a contiguous column and each category is a selection
+// bitmap over it, so every statistic comes out of one vectorized pass.
+void Array::analyzePriceStatistics(long long& duration_ms) {
     auto start = std::chrono::high_resolution_clock::now();
-    const int MAX_WORDS = 1000;
-    WordFrequency word_freq[MAX_WORDS];
-    int word_count = 0;
 
-    // Collect words from 1-star reviews using linear search
-    for (int i = 0; i < rev_size; i++) {
-        if (reviews[i].rating == 1) {
-            std::string words[100];
-            int num_words;
-
-            auto splitWords = [](const std::string& text, std::string* words, int& num_words) {
-                std::string word;
-                num_words = 0;
-                for (char c : text) {
-                    if (std::isalnum(c)) word += std::tolower(c);
-                    else if (!word.empty()) {
-                        words[num_words++] = word;
-                        word.clear();
-                    }
-                }
-                if (!word.empty()) words[num_words++] = word;
-            };
-
-            splitWords(reviews[i].review_text, words, num_words);
-            for (int j = 0; j < num_words; j++) {
-                std::string word = words[j];
-                bool found = false;
-                for (int k = 0; k < word_count; k++) {
-                    if (word_freq[k].word == word) {
-                        word_freq[k].count++;
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found && word_count < MAX_WORDS) {
-                    word_freq[word_count].word = word;
-                    word_freq[word_count].count = 1;
-                    word_count++;
-                }
-            }
+    std::vector<double> prices(trans_size);
+    std::vector<std::string> categories;
+    std::vector<std::vector<uint64_t>> selections;
+    for (int i = 0; i < trans_size; i++) {
+        prices[i] = transactions[i].price;
+        int code = 0;
+        while (code < static_cast<int>(categories.size()) && categories[code] != transactions[i].category) code++;
+        if (code == static_cast<int>(categories.size())) {
+            categories.push_back(transactions[i].category);
+            selections.push_back(std::vector<uint64_t>(selectionWords(trans_size), 0));
         }
+        selectRow(selections[code].data(), i);
     }
 
-    // Sort word frequencies based on sort_choice
-    switch (sort_choice) {
-        case 1: // Bubble Sort
-            std::cout << "[Bubble Sort] ";
-            for (int i = 0; i < word_count - 1; i++) {
-                for (int j = 0; j < word_count - i - 1; j++) {
-                    if (word_freq[j].count < word_freq[j + 1].count) {
-                        std::swap(word_freq[j], word_freq[j + 1]);
-                    }
-                }
-            }
-            break;
-        case 2: // Insertion Sort
-            std::cout << "[Insertion Sort] ";
-            for (int i = 1; i < word_count; i++) {
-                WordFrequency key = word_freq[i];
-                int j = i - 1;
-                while (j >= 0 && word_freq[j].count < key.count) {
-                    word_freq[j + 1] = word_freq[j];
-                    j--;
-                }
-                word_freq[j + 1] = key;
-            }
-            break;
-        case 3: // Selection Sort
-            std::cout << "[Selection Sort] ";
-            for (int i = 0; i < word_count - 1; i++) {
-                int max_idx = i;
-                for (int j = i + 1; j < word_count; j++) {
-                    if (word_freq[j].count > word_freq[max_idx].count) max_idx = j;
-                }
-                if (max_idx != i) std::swap(word_freq[i], word_freq[max_idx]);
-            }
-            break;
-        case 4: // Merge Sort
-            std::cout << "[Merge Sort] ";
-            {
-                auto merge_words = [&](int left, int mid, int right) {
-                    int n1 = mid - left + 1;
-                    int n2 = right - mid;
-                    WordFrequency* L = new WordFrequency[n1];
-                    WordFrequency* R = new WordFrequency[n2];
-                    for (int i = 0; i < n1; i++) L[i] = word_freq[left + i];
-                    for (int j = 0; j < n2; j++) R[j] = word_freq[mid + 1 + j];
-                    int i = 0, j = 0, k = left;
-                    while (i < n1 && j < n2) {
-                        if (L[i].count >= R[j].count) word_freq[k++] = L[i++];
-                        else word_freq[k++] = R[j++];
-                    }
-                    while (i < n1) word_freq[k++] = L[i++];
-                    while (j < n2) word_freq[k++] = R[j++];
-                    delete[] L;
-                    delete[] R;
-                };
-                std::function<void(int, int, decltype(merge_words)&)> merge_sort_words =
-                    [&](int left, int right, auto& merge_fn) {
-                        if (left < right) {
-                            int mid = left + (right - left) / 2;
-                            merge_sort_words(left, mid, merge_fn);
-                            merge_sort_words(mid + 1, right, merge_fn);
-                            merge_fn(left, mid, right);
-                        }
-                    };
-                merge_sort_words(0, word_count - 1, merge_words);
-            }
-            break;
-        default:
-            std::cout << "Invalid sort choice. Using Insertion Sort.\n";
-            std::cout << "[Insertion Sort] ";
-            for (int i = 1; i < word_count; i++) {
-                WordFrequency key = word_freq[i];
-                int j = i - 1;
-                while (j >= 0 && word_freq[j].count < key.count) {
-                    word_freq[j + 1] = word_freq[j];
-                    j--;
-                }
-                word_freq[j + 1] = key;
-            }
-            break;
+    PriceStats overall = computePriceStats(prices.data(), trans_size);
+    std::vector<PriceStats> per_category(categories.size());
+    for (size_t c = 0; c < categories.size(); c++) {
+        per_category[c] = computePriceStats(prices.data(), trans_size, selections[c].data());
     }
 
     auto end = std::chrono::high_resolution_clock::now();
     duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 
-    int top_n = 5;
-    if (word_count < top_n) top_n = word_count;
+    std::vector<int> order(categories.size());
+    for (size_t c = 0; c < order.size(); c++) order[c] = static_cast<int>(c);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return categories[a] < categories[b]; });
+
     std::cout << "Execution time: " << duration_ms << " ms\n";
-    std::cout << "Top " << top_n << " frequent words in 1-star reviews:\n";
-    for (int i = 0; i < top_n; i++) {
-        std::cout << word_freq[i].word << ": " << word_freq[i].count << "\n";
+    std::cout << "\nPrice Statistics by Category:\n";
+    std::cout << std::left << std::setw(16) << "Category"
+              << " | " << std::setw(6) << "Count"
+              << " | " << std::setw(12) << "Sum"
+              << " | " << std::setw(8) << "Mean"
+              << " | " << std::setw(8) << "Min"
+              << " | " << std::setw(8) << "Max"
+              << " | " << "Variance" << std::endl;
+    std::cout << std::string(90, '-') << std::endl;
+    auto printStats = [](const std::string& name, const PriceStats& s) {
+        std::cout << std::left << std::setw(16) << name << " | "
+                  << std::setw(6) << s.count << " | "
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(12) << s.sum << " | "
+                  << std::setw(8) << s.mean << " | "
+                  << std::setw(8) << s.min << " | "
+                  << std::setw(8) << s.max << " | "
+                  << s.variance << std::endl;
+    };
+    for (int c : order) printStats(categories[c], per_category[c]);
+    printStats("ALL", overall);
+
+    std::cout << "\nPrice Band Counts:\n";
+    std::cout << std::left << std::setw(16) << "Category";
+    for (int b = 0; b < PRICE_BANDS; b++) {
+        std::string label;
+        if (b == 0) label = "<" + std::to_string(static_cast<int>(PRICE_BAND_EDGE[0]));
+        else if (b == PRICE_BANDS - 1) label = ">=" + std::to_string(static_cast<int>(PRICE_BAND_EDGE[b - 1]));
+        else label = std::to_string(static_cast<int>(PRICE_BAND_EDGE[b - 1])) + "-" +
+                     std::to_string(static_cast<int>(PRICE_BAND_EDGE[b]));
+        std::cout << " | " << std::setw(9) << label;
     }
-}
+    std::cout << std::endl << std::string(16 + 12 * PRICE_BANDS, '-') << std::endl;
+    auto printBands = [](const std::string& name, const PriceStats& s) {
+        std::cout << std::left << std::setw(16) << name;
+        for (int b = 0; b < PRICE_BANDS; b++) std::cout << " | " << std::setw(9) << s.band_counts[b];
+        std::cout << std::endl;
+    };
+    for (int c : order) printBands(categories[c], per_category[c]);
+    printBands("ALL", overall);
+}
+
+// Question 5: reviews mentioning all (AND) or any (OR) of the query words,
+// answered from the review index
+void Array::searchReviewsByKeywords(const std::string& query, bool match_all, long long& duration_ms) {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::string> terms;
+    forEachWord(query, [&](const std::string& word) { terms.push_back(word); });
+    const ReviewIndex& index = reviewIndex();
+    std::vector<int> rows = match_all ? index.reviewsMentioningAll(terms) : index.reviewsMentioningAny(terms);
+    auto end = std::chrono::high_resolution_clock::now();
+    duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 
+    std::cout << (match_all ? "[AND] " : "[OR] ") << "Execution time: " << duration_ms << " ms\n";
+    if (terms.empty()) {
+        std::cout << "No keywords given.\n";
+        return;
+    }
+    std::cout << "Reviews matching: " << rows.size() << "\n";
 
-// Free function implementations
+    int by_rating[INDEX_MAX_RATING + 1] = {0};
+    for (int row : rows) {
+        int rating = reviews[row].rating;
+        by_rating[(rating >= 1 && rating <= INDEX_MAX_RATING) ? rating : 0]++;
+    }
+    std::cout << "\nMatching reviews by rating:\n";
+    for (int r = 1; r <= INDEX_MAX_RATING; r++) std::cout << r << "-star: " << by_rating[r] << "\n";
+
+    std::cout << "\nKeyword occurrences by rating:\n";
+    std::cout << std::left << std::setw(16) << "Keyword";
+    for (int r = 1; r <= INDEX_MAX_RATING; r++) std::cout << " | " << r << "-star";
+    std::cout << std::endl << std::string(16 + 9 * INDEX_MAX_RATING, '-') << std::endl;
+    for (const std::string& term : terms) {
+        std::cout << std::left << std::setw(16) << term;
+        for (int r = 1; r <= INDEX_MAX_RATING; r++) std::cout << " | " << std::setw(6) << index.occurrences(term, r);
+        std::cout << std::endl;
+    }
 
-std::string trim(const std::string& str) {
-    size_t start = str.find_first_not_of(" \t\n\r\f\v");
-    if (start == std::string::npos) return "";
-    size_t end = str.find_last_not_of(" \t\n\r\f\v");
-    return str.substr(start, end - start + 1);
+    std::cout << "\nSample matching reviews:\n";
+    for (size_t i = 0; i < rows.size() && i < 5; i++) {
+        const Review& r = reviews[rows[i]];
+        std::cout << r.product_id << " (" << r.rating << "-star): " << r.review_text << "\n";
+    }
 }
 
-std::string to_lowercase(const std::string& str) {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(), ::tolower);
-    return result;
+// benchmark.cpp links this file with PR1_NO_MAIN defined
+#ifndef PR1_NO_MAIN
+// Runs one question; choices that don't apply to it are ignored
+void runQuestion(DataStore<ArrayBackend>& store, int question_choice, int search_choice, int sort_choice,
+                 const std::string& query) {
+    Array& arr = store.storage().array();
+    long long duration_ms = 0;
+    if (question_choice >= 1 && question_choice <= 3) {
+        store.runQuestion(question_choice, search_choice, sort_choice);
+    } else if (question_choice == 4) {
+        arr.analyzePriceStatistics(duration_ms);
+    } else if (question_choice == 5) {
+        arr.searchReviewsByKeywords(query, search_choice != 2, duration_ms);
+    }
 }
 
-void loadTransactions(Array& arr, const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error opening transactions file: " << filename << "\n";
-        return;
+int main(int argc, char* argv[]) {
+    DataStore<ArrayBackend> store;
+    Array& arr = store.storage().array();
+    // Command-line options:
+    //   --threads N    thread count for the linear scans. Each thread needs at least
+    //                  MIN_ROWS_PER_CHUNK (4096) rows, so the bundled CSVs (about
+    //                  4100 transactions) are scanned on one thread whatever N is.
+    //   --question Q   run question Q once without the menu, then exit
+    //   --search S     search choice for questions 2 and 3, or 1 = AND / 2 = OR for question 5 (default 1)
+    //   --sort S       sort choice for questions 1-3 (default 4)
+    //   --query "..."  keywords for question 5
+    int cli_question = 0, cli_search = 1, cli_sort = 4;
+    std::string cli_query;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        int value = std::atoi(argv[i + 1]);
+        if (option == "--threads") arr.setScanThreads(value);
+        else if (option == "--question") cli_question = value;
+        else if (option == "--search") cli_search = value;
+        else if (option == "--sort") cli_sort = value;
+        else if (option == "--query") cli_query = argv[i + 1];
+        else std::cerr << "Unknown option: " << option << "\n";
     }
-    std::string line;
-    std::getline(file, line);
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string token;
-        Transaction t;
-        int field = 0;
-        while (std::getline(ss, token, ',')) {
-            token = trim(token);
-            if (field == 0) t.customer_id = token;
-            else if (field == 1) t.product = token;
-            else if (field == 2) t.category = to_lowercase(token);
-            else if (field == 3) t.price = std::stod(token);
-            else if (field == 4) t.date = token;
-            else if (field == 5) t.payment_method = to_lowercase(token);
-            field++;
-        }
-        arr.addTransaction(t);
+    if (!store.loadTransactions("transactions_cleaned.csv")) {
+        std::cerr << "Error opening transactions file: transactions_cleaned.csv\n";
     }
-    file.close();
-}
-
-void loadReviews(Array& arr, const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error opening reviews file: " << filename << "\n";
-        return;
+    if (!store.loadReviews("reviews_cleaned.csv")) {
+        std::cerr << "Error opening reviews file: reviews_cleaned.csv\n";
     }
-    std::string line;
-    std::getline(file, line);
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string token;
-        Review r;
-        int field = 0;
-        while (std::getline(ss, token, ',')) {
-            token = trim(token);
-            if (field == 0) r.product_id = token;
-            else if (field == 1) r.customer_id = token;
-            else if (field == 2) r.rating = std::stoi(token);
-            else if (field == 3) {
-                r.review_text = token;
-                std::string remaining;
-                std::getline(ss, remaining);
-                if (!remaining.empty()) r.review_text += "," + remaining;
-            }
-            field++;
+    arr.buildReviewIndex();
+
+    if (cli_question != 0) {
+        if (cli_question < 1 || cli_question > 5) {
+            std::cerr << "Invalid question: " << cli_question << " (expected 1-5)\n";
+            return 1;
         }
-        arr.addReview(r);
+        runQuestion(store, cli_question, cli_search, cli_sort, cli_query);
+        return 0;
     }
-    file.close();
-}
-
-int main() {
-    Array arr;
-    loadTransactions(arr, "transactions_cleaned.csv");
-    loadReviews(arr, "reviews_cleaned.csv");
 
     while (true) {
         std::cout << "\nE-commerce Transaction Analysis System\n";
         std::cout << "1. Sort transactions by date\n";
         std::cout << "2. Calculate Electronics purchases with Credit Card percentage\n";
         std::cout << "3. Find frequent words in 1-star reviews\n";
-        std::cout << "4. Exit\n";
-        std::cout << "Enter choice (1-4): ";
+        std::cout << "4. Price statistics by category\n";
+        std::cout << "5. Search reviews by keyword\n";
+        std::cout << "6. Exit\n";
+        std::cout << "Enter choice (1-6): ";
         int question_choice;
         std::cin >> question_choice;
 
-        if (question_choice == 4) {
+        if (question_choice == 6) {
             std::cout << "Exiting program.\n";
             break;
         }
 
-        long long duration_ms = 0;
+        int search_choice = 0;
+        int sort_choice = 0;
+        std::string query;
 
         if (question_choice == 1) {
             std::cout << "\nChoose Sorting Algorithm:\n";
@@ -797,17 +657,15 @@ int main() {
             std::cout << "3. Selection Sort\n";
             std::cout << "4. Merge Sort\n";
             std::cout << "Enter choice (1-4): ";
-            int sort_choice;
             std::cin >> sort_choice;
-            arr.sortTransactionsByDate(sort_choice, duration_ms);
         } else if (question_choice == 2) {
             std::cout << "\nChoose Search Algorithm:\n";
             std::cout << "1. Linear Search\n";
             std::cout << "2. Binary Search\n";
             std::cout << "3. Jump Search\n";
             std::cout << "4. Interpolation Search\n";
-            std::cout << "Enter choice (1-4): ";
-            int search_choice;
+            std::cout << "5. S-Tree Search\n";
+            std::cout << "Enter choice (1-5): ";
             std::cin >> search_choice;
 
             std::cout << "\nChoose Sorting Algorithm:\n";
@@ -816,23 +674,40 @@ int main() {
             std::cout << "3. Selection Sort\n";
             std::cout << "4. Merge Sort\n";
             std::cout << "Enter choice (1-4): ";
-            int sort_choice;
             std::cin >> sort_choice;
-
-            arr.calculateElectronicsCreditCardPercentage(search_choice, sort_choice, duration_ms);
         } else if (question_choice == 3) {
+            std::cout << "\nChoose how to find the 1-star reviews:\n";
+            std::cout << "1. Review index\n";
+            std::cout << "2. Binary Search\n";
+            std::cout << "3. Jump Search\n";
+            std::cout << "4. Interpolation Search\n";
+            std::cout << "5. S-Tree Search\n";
+            std::cout << "Enter choice (1-5): ";
+            std::cin >> search_choice;
+
             std::cout << "\nChoose Sorting Algorithm for word frequencies:\n";
             std::cout << "1. Bubble Sort\n";
             std::cout << "2. Insertion Sort\n";
             std::cout << "3. Selection Sort\n";
             std::cout << "4. Merge Sort\n";
             std::cout << "Enter choice (1-4): ";
-            int search_choice;
+            std::cin >> sort_choice;
+        } else if (question_choice == 5) {
+            std::cout << "\nEnter keywords: ";
+            std::cin >> std::ws;
+            std::getline(std::cin, query);
+            std::cout << "\nMatch:\n";
+            std::cout << "1. All keywords (AND)\n";
+            std::cout << "2. Any keyword (OR)\n";
+            std::cout << "Enter choice (1-2): ";
             std::cin >> search_choice;
-            arr.findFrequentWordsInOneStarReviews(search_choice, duration_ms);
-        } else {
-            std::cout << "Invalid choice. Please select 1, 2, 3, or 4.\n";
+        } else if (question_choice != 4) {
+            std::cout << "Invalid choice. Please select 1, 2, 3, 4, 5, or 6.\n";
+            continue;
         }
+
+        runQuestion(store, question_choice, search_choice, sort_choice, query);
     }
     return 0;
-}
\ No newline at end of file
+}
+#endif // PR1_NO_MAIN
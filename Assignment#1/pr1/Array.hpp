@@ -3,24 +3,11 @@
 
 #include <string>
 #include <iostream>
-
-// Struct to represent a transaction from transactions.csv
-struct Transaction {
-    std::string customer_id;
-    std::string product;
-    std::string category;
-    double price;
-    std::string date; // Standardized to "YYYYMMDD"
-    std::string payment_method;
-};
-
-// Struct to represent a review from reviews.csv
-struct Review {
-    std::string product_id;
-    std::string customer_id;
-    int rating;
-    std::string review_text;
-};
+#include "records.hpp"
+#include "parallel_scan.hpp"
+#include "s_tree.hpp"
+#include "price_kernels.hpp"
+#include "inverted_index.hpp"
 
 // Struct to hold word frequency data for Question 3
 struct WordFrequency {
@@ -37,14 +24,28 @@ private:
     Review* reviews;
     int rev_size;
     int rev_capacity;
+    int scan_threads;
+    ScanThreadPool* scan_pool;
+
+    // Static search indexes over the current (sorted) order; rebuilt lazily after changes
+    STreeStringIndex category_index;
+    STree date_index;
+    STree rating_index;
+    bool category_index_valid;
+    bool date_index_valid;
+    bool rating_index_valid;
+    ReviewIndex review_index;
+    bool review_index_valid;
 
     void resizeTransactions();
+    ScanThreadPool& scanPool();
     void resizeReviews();
+    void invalidateTransactionIndexes();
+    void invalidateReviewIndexes();
     void merge(int left, int mid, int right, bool by_category);
     void mergeSortHelper(int left, int right, bool by_category);
     void mergeReviews(int left, int mid, int right);
     void mergeSortReviewsHelper(int left, int right);
-    void displaySampleTransactions(const Array& arr, int count = 5);
 
 public:
     Array(int initial_capacity = 10);
@@ -54,20 +55,35 @@ public:
     void addReview(const Review& r);
     Transaction getTransaction(int index) const;
     Review getReview(int index) const;
+    // Unchecked access without copying the record
+    const Transaction& transactionAt(int index) const { return transactions[index]; }
+    const Review& reviewAt(int index) const { return reviews[index]; }
     int getTransSize() const;
     int getRevSize() const;
 
+    // Number of threads used by the linear scans (1 = single-threaded)
+    void setScanThreads(int threads);
+    int getScanThreads() const;
+
+    // Inverted index over review text; built at load, rebuilt on use if reviews changed
+    void buildReviewIndex();
+    const ReviewIndex& reviewIndex();
+
     // Search Algorithms for Transactions
     int linearSearchByCategory(const std::string& category);
     int binarySearchByCategory(const std::string& category);
     int jumpSearchByCategory(const std::string& category);
     int interpolationSearchByCategory(const std::string& category);
+    int sTreeSearchByCategory(const std::string& category);
+    // First row dated date_key or later, or the row count
+    int sTreeLowerBoundByDate(int date_key);
 
     // Search Algorithms for Reviews
     int linearSearchByRating(int rating);
     int binarySearchByRating(int rating);
     int jumpSearchByRating(int rating);
     int interpolationSearchByRating(int rating);
+    int sTreeSearchByRating(int rating);
 
     // Sort Algorithms for Transactions by Category
     void bubbleSortByCategory();
@@ -85,16 +101,22 @@ public:
     void bubbleSortByRating();
     void mergeSortByRating();
 
-    // Methods for Assignment Questions
-    void sortTransactionsByDate(int sort_choice, long long& duration_ms);
-    double calculateElectronicsCreditCardPercentage(int search_choice, int sort_choice, long long& duration_ms);
-    void findFrequentWordsInOneStarReviews(int search_choice, long long& duration_ms);
+    // Rows of a category and, among those, rows paid with a payment method.
+    // search_choice 1 = linear (parallel scan); 2-5 = binary, jump, interpolation
+    // or S-tree search after sorting by category with sort_choice (1-4 = bubble,
+    // insertion, selection, merge). Returns the search used, 1 for an unknown choice.
+    int countCategoryAndPayment(const std::string& category, const std::string& payment,
+                                int& category_count, int& payment_count, int search_choice, int sort_choice);
+
+    // Word counts over the reviews with a rating. search_choice 1 reads them
+    // from the review index; 2-5 merge-sort the reviews by rating, find the
+    // run with binary, jump, interpolation or S-tree search and split its
+    // texts. Returns the search used, 1 for an unknown choice.
+    int countWordsByRating(int rating, std::vector<WordFrequency>& words, int search_choice);
+
+    // Questions 4 and 5; Q1-Q3 are answered by DataStore (datastore.hpp)
+    void analyzePriceStatistics(long long& duration_ms);
+    void searchReviewsByKeywords(const std::string& query, bool match_all, long long& duration_ms);
 };
 
-// Free function declarations
-std::string trim(const std::string& str);
-std::string to_lowercase(const std::string& str);
-void loadTransactions(Array& arr, const std::string& filename);
-void loadReviews(Array& arr, const std::string& filename);
-
 #endif // ARRAY_HPP
\ No newline at end of file
@@ -0,0 +1,98 @@
+// Data-structure benchmark: loads the same CSV files into every DataStore
+// backend and times loading and Q1-Q3, which run through the one shared
+// implementation in datastore.hpp. Answers are checked to agree across backends.
+//
+// Build: g++ -std=c++14 -O2 -pthread -DPR1_NO_MAIN benchmark.cpp Array.cpp linked-list.cpp -o benchmark
+// Run:   ./benchmark [transactions.csv] [reviews.csv]
+
+#include "datastore.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Answers of one backend, compared against the first backend's
+struct QuestionResults {
+    std::vector<DateCount> dateCounts;
+    int electronics;
+    int creditCard;
+    std::vector<WordFrequency> words;
+
+    bool operator==(const QuestionResults& other) const {
+        if (dateCounts.size() != other.dateCounts.size() || electronics != other.electronics ||
+            creditCard != other.creditCard || words.size() != other.words.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < dateCounts.size(); i++) {
+            const DateCount& a = dateCounts[i];
+            const DateCount& b = other.dateCounts[i];
+            if (a.key != b.key || a.date != b.date || a.count != b.count) return false;
+        }
+        for (size_t i = 0; i < words.size(); i++) {
+            if (words[i].word != other.words[i].word || words[i].count != other.words[i].count) return false;
+        }
+        return true;
+    }
+};
+
+static double millisecondsSince(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+template <typename Backend>
+QuestionResults runBackend(const std::string& transactionsFile, const std::string& reviewsFile) {
+    DataStore<Backend> store;
+    QuestionResults results;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if (!store.loadTransactions(transactionsFile)) std::cerr << "Error opening " << transactionsFile << "\n";
+    if (!store.loadReviews(reviewsFile)) std::cerr << "Error opening " << reviewsFile << "\n";
+    double load = millisecondsSince(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    results.dateCounts = store.countTransactionsByDate();
+    double q1 = millisecondsSince(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    store.countElectronicsCreditCard(results.electronics, results.creditCard);
+    double q2 = millisecondsSince(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    store.frequentWordsInOneStarReviews(10, results.words);
+    double q3 = millisecondsSince(start);
+
+    std::cout << std::left << std::setw(16) << DataStore<Backend>::name()
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << load << std::setw(12) << q1 << std::setw(12) << q2 << std::setw(12) << q3 << "\n";
+    return results;
+}
+
+int main(int argc, char* argv[]) {
+    std::string transactionsFile = argc > 1 ? argv[1] : "transactions_cleaned.csv";
+    std::string reviewsFile = argc > 2 ? argv[2] : "reviews_cleaned.csv";
+
+    std::cout << "Times in ms\n";
+    std::cout << std::left << std::setw(16) << "Backend" << std::right << std::setw(12) << "Load"
+              << std::setw(12) << "Q1 sort" << std::setw(12) << "Q2 scan" << std::setw(12) << "Q3 words" << "\n";
+    std::cout << std::string(64, '-') << "\n";
+
+    std::vector<QuestionResults> results;
+    results.push_back(runBackend<ArrayBackend>(transactionsFile, reviewsFile));
+    results.push_back(runBackend<LinkedListBackend>(transactionsFile, reviewsFile));
+    results.push_back(runBackend<UnrolledListBackend>(transactionsFile, reviewsFile));
+    results.push_back(runBackend<ColumnarBackend>(transactionsFile, reviewsFile));
+
+    bool agree = true;
+    for (size_t i = 1; i < results.size(); i++) agree = agree && results[i] == results[0];
+
+    const QuestionResults& r = results[0];
+    double percentage = r.electronics > 0 ? static_cast<double>(r.creditCard) / r.electronics * 100.0 : 0.0;
+    std::cout << "\nQ1: " << r.dateCounts.size() << " distinct dates\n";
+    std::cout << "Q2: " << r.creditCard << " of " << r.electronics << " electronics purchases by credit card ("
+              << std::setprecision(2) << percentage << "%)\n";
+    std::cout << "Q3:";
+    for (const WordFrequency& w : r.words) std::cout << " " << w.word << "(" << w.count << ")";
+    std::cout << "\n" << (agree ? "All backends agree.\n" : "Backends DISAGREE.\n");
+    return agree ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+#ifndef CSV_PARSER_HPP
+#define CSV_PARSER_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <climits>
+
+// One field of the current CSV row. It points into the reader's buffer and is
+// only valid until the next call to CsvReader::nextRow().
+struct CsvField {
+    const char* data;
+    int size;
+
+    std::string str() const { return std::string(data, size); }
+
+    // The field without leading/trailing whitespace
+    CsvField trimmed() const {
+        const char* begin = data;
+        const char* end = data + size;
+        while (begin < end && (*begin == ' ' || *begin == '\t')) begin++;
+        while (end > begin && (end[-1] == ' ' || end[-1] == '\t')) end--;
+        return CsvField{begin, static_cast<int>(end - begin)};
+    }
+};
+
+// A row the reader or a loader rejected, with the line it started on
+struct CsvRowError {
+    int line;
+    std::string message;
+};
+
+// Single-pass RFC 4180 reader. The whole file is read into memory and split in
+// place: quoted fields may contain commas, line breaks and doubled quotes (""),
+// which are unescaped inside the buffer. CRLF, LF and CR line endings are accepted.
+// Malformed rows are recorded in errors() instead of throwing.
+class CsvReader {
+private:
+    std::string buffer;
+    char* pos;
+    char* end;
+    int line;
+    int row_line;
+    bool row_valid;
+    std::vector<CsvField> fields;
+    std::vector<CsvRowError> row_errors;
+    bool is_delimiter[256];
+
+    static int countNewlines(const char* begin, const char* finish) {
+        return static_cast<int>(std::count(begin, finish, '\n'));
+    }
+
+    // Reads a quoted field starting at the opening quote and unescapes it in place
+    CsvField readQuoted() {
+        char* p = pos + 1;
+        char* start = p;
+        char* out = p;
+        while (true) {
+            char* quote = static_cast<char*>(std::memchr(p, '"', end - p));
+            if (quote == nullptr) {
+                line += countNewlines(p, end);
+                std::memmove(out, p, end - p);
+                out += end - p;
+                p = end;
+                reportError("unterminated quoted field");
+                break;
+            }
+            line += countNewlines(p, quote);
+            if (out != p) std::memmove(out, p, quote - p);
+            out += quote - p;
+            if (quote + 1 < end && quote[1] == '"') {
+                *out++ = '"';
+                p = quote + 2;
+                continue;
+            }
+            p = quote + 1;
+            break;
+        }
+        if (p < end && !is_delimiter[static_cast<unsigned char>(*p)]) {
+            reportError("unexpected character after closing quote");
+            while (p < end && !is_delimiter[static_cast<unsigned char>(*p)]) p++;
+        }
+        pos = p;
+        return CsvField{start, static_cast<int>(out - start)};
+    }
+
+public:
+    CsvReader() : pos(nullptr), end(nullptr), line(1), row_line(0), row_valid(true) {
+        std::memset(is_delimiter, 0, sizeof(is_delimiter));
+        is_delimiter[static_cast<unsigned char>(',')] = true;
+        is_delimiter[static_cast<unsigned char>('\n')] = true;
+        is_delimiter[static_cast<unsigned char>('\r')] = true;
+    }
+
+    bool open(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) return false;
+        file.seekg(0, std::ios::end);
+        std::streamoff length = file.tellg();
+        file.seekg(0, std::ios::beg);
+        buffer.resize(length > 0 ? static_cast<size_t>(length) : 0);
+        if (length > 0) file.read(&buffer[0], length);
+        pos = buffer.empty() ? nullptr : &buffer[0];
+        end = pos + buffer.size();
+        line = 1;
+        row_errors.clear();
+        return true;
+    }
+
+    // Advances to the next non-blank row; returns false at the end of the file.
+    bool nextRow() {
+        fields.clear();
+        row_valid = true;
+        // Skip blank lines
+        while (pos < end && (*pos == '\n' || *pos == '\r')) {
+            if (*pos == '\n') line++;
+            pos++;
+        }
+        if (pos >= end) return false;
+        row_line = line;
+        while (true) {
+            if (*pos == '"') {
+                fields.push_back(readQuoted());
+            } else {
+                char* start = pos;
+                while (pos < end && !is_delimiter[static_cast<unsigned char>(*pos)]) pos++;
+                fields.push_back(CsvField{start, static_cast<int>(pos - start)});
+            }
+            if (pos >= end) break;
+            if (*pos == ',') {
+                pos++;
+                if (pos >= end) {
+                    fields.push_back(CsvField{pos, 0});
+                    break;
+                }
+                continue;
+            }
+            // Row ends at \n, \r\n or \r
+            if (*pos == '\r') {
+                pos++;
+                if (pos < end && *pos == '\n') pos++;
+            } else {
+                pos++;
+            }
+            line++;
+            break;
+        }
+        return true;
+    }
+
+    int fieldCount() const { return static_cast<int>(fields.size()); }
+    const CsvField& field(int i) const { return fields[i]; }
+    int rowLine() const { return row_line; }
+    // False once the reader or a loader has reported an error for this row
+    bool rowValid() const { return row_valid; }
+
+    // Records an error for the current row and marks it invalid
+    void reportError(const std::string& message) {
+        if (row_valid) row_errors.push_back(CsvRowError{row_line, message});
+        row_valid = false;
+    }
+
+    const std::vector<CsvRowError>& errors() const { return row_errors; }
+};
+
+// Prints how many rows were skipped and the first few reasons
+inline void printCsvErrors(const std::string& filename, const std::vector<CsvRowError>& errors) {
+    if (errors.empty()) return;
+    std::cerr << "Skipped " << errors.size() << " malformed row(s) in " << filename << "\n";
+    for (size_t i = 0; i < errors.size() && i < 5; i++) {
+        std::cerr << "  line " << errors[i].line << ": " << errors[i].message << "\n";
+    }
+}
+
+// Integer and decimal parsing without exceptions or locale lookups; both
+// return false unless the whole (trimmed) field is a valid number.
+inline bool parseCsvInt(const CsvField& field, int& out) {
+    CsvField f = field.trimmed();
+    const char* p = f.data;
+    const char* end = f.data + f.size;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')) negative = *p++ == '-';
+    if (p == end) return false;
+    long long value = 0;
+    for (; p < end; p++) {
+        unsigned digit = static_cast<unsigned>(*p - '0');
+        if (digit > 9) return false;
+        value = value * 10 + digit;
+        if (value > static_cast<long long>(INT_MAX) + 1) return false;
+    }
+    if (negative) value = -value;
+    if (value > INT_MAX || value < INT_MIN) return false;
+    out = static_cast<int>(value);
+    return true;
+}
+
+inline bool parseCsvDouble(const CsvField& field, double& out) {
+    static const double POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    CsvField f = field.trimmed();
+    const char* p = f.data;
+    const char* end = f.data + f.size;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')) negative = *p++ == '-';
+
+    uint64_t mantissa = 0;
+    int digits = 0;     // significant digits kept in mantissa
+    int exponent = 0;
+    bool any_digit = false;
+    for (; p < end && static_cast<unsigned>(*p - '0') <= 9; p++) {
+        any_digit = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+            if (mantissa != 0) digits++;
+        } else {
+            exponent++;
+        }
+    }
+    if (p < end && *p == '.') {
+        for (p++; p < end && static_cast<unsigned>(*p - '0') <= 9; p++) {
+            any_digit = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                if (mantissa != 0) digits++;
+                exponent--;
+            }
+        }
+    }
+    if (!any_digit) return false;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool exp_negative = false;
+        if (p < end && (*p == '+' || *p == '-')) exp_negative = *p++ == '-';
+        if (p == end) return false;
+        int e = 0;
+        for (; p < end; p++) {
+            unsigned digit = static_cast<unsigned>(*p - '0');
+            if (digit > 9) return false;
+            if (e < 100000) e = e * 10 + static_cast<int>(digit);
+        }
+        exponent += exp_negative ? -e : e;
+    }
+    if (p != end) return false;
+
+    // Exact when the mantissa and the power of ten are both exactly representable
+    if (digits <= 15 && exponent >= -22 && exponent <= 22) {
+        double value = static_cast<double>(mantissa);
+        value = exponent < 0 ? value / POW10[-exponent] : value * POW10[exponent];
+        out = negative ? -value : value;
+        return true;
+    }
+    std::string copy(f.data, f.size);
+    out = std::strtod(copy.c_str(), nullptr);
+    return true;
+}
+
+#endif // CSV_PARSER_HPP
@@ -0,0 +1,468 @@
+#ifndef DATASTORE_HPP
+#define DATASTORE_HPP
+
+#include "records.hpp"
+#include "Array.hpp"
+#include "linked-list.hpp"
+#include "csv_parser.hpp"
+#include "inverted_index.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <utility>
+#include <cctype>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+// Storage backends for DataStore. Each keeps the records its own way and
+// provides the same operations:
+//   void addTransaction(const Transaction& t), void addReview(const Review& r)
+//   int transactionCount() const, int reviewCount() const
+//   void sortByDate(int sortChoice)      stable, ascending by date (1-4 = bubble,
+//                                        insertion, selection, merge sort)
+//   forEachDateRun(fn(int dateKey, const std::string& date, int count))
+//                                        once per date, in order, after sortByDate
+//   int countCategoryAndPayment(category, payment, int& categoryCount, int& paymentCount,
+//                               int searchChoice, int sortChoice)
+//   int countWordsByRating(int rating, std::vector<WordFrequency>& words, int searchChoice)
+// The two counts return the search used, 1 if the backend lacks searchChoice.
+// The visitors hand out only the fields a question reads, so the columnar
+// backend touches just those columns while the row stores walk whole records.
+
+// Date runs found by reading every date in order, for backends that walk
+// them with forEachDate(fn(dateKey, date))
+template <typename Backend, typename Fn>
+void scanDateRuns(const Backend& backend, Fn fn) {
+    int runKey = 0, runCount = 0;
+    const std::string* runDate = nullptr;
+    backend.forEachDate([&](int key, const std::string& date) {
+        if (runCount > 0 && key == runKey) {
+            runCount++;
+            return;
+        }
+        if (runCount > 0) fn(runKey, *runDate, runCount);
+        runKey = key;
+        runDate = &date;
+        runCount = 1;
+    });
+    if (runCount > 0) fn(runKey, *runDate, runCount);
+}
+
+// Word counts over the reviews with the given rating, split the way Q3 splits
+// them, for backends that walk their reviews with forEachReview(fn(rating, text))
+template <typename Backend>
+void countWordsInReviews(const Backend& backend, int rating, std::vector<WordFrequency>& words) {
+    std::unordered_map<std::string, int> counts;
+    backend.forEachReview([&](int reviewRating, const std::string& text) {
+        if (reviewRating == rating) forEachWord(text, [&](const std::string& word) { counts[word]++; });
+    });
+    words.reserve(words.size() + counts.size());
+    for (const auto& entry : counts) words.push_back(WordFrequency{entry.first, entry.second});
+}
+
+// Contiguous array of records (Array.hpp)
+class ArrayBackend {
+private:
+    Array arr;
+
+public:
+    static const char* name() { return "Array"; }
+    // The array itself, for its settings and the questions only it answers (Q4, Q5)
+    Array& array() { return arr; }
+
+    void addTransaction(const Transaction& t) { arr.addTransaction(t); }
+    void addReview(const Review& r) { arr.addReview(r); }
+    int transactionCount() const { return arr.getTransSize(); }
+    int reviewCount() const { return arr.getRevSize(); }
+
+    void sortByDate(int sortChoice) {
+        if (sortChoice == 1) arr.bubbleSortByDate();
+        else if (sortChoice == 2) arr.insertionSortByDate();
+        else if (sortChoice == 3) arr.selectionSortByDate();
+        else arr.mergeSortByDate();
+    }
+
+    // Each run ends where the S-tree date index finds the next date, so only
+    // the first row of a date is read
+    template <typename Fn>
+    void forEachDateRun(Fn fn) {
+        int row = 0;
+        while (row < arr.getTransSize()) {
+            const Transaction& t = arr.transactionAt(row);
+            int end = arr.sTreeLowerBoundByDate(t.date_key + 1);
+            fn(t.date_key, t.date, end - row);
+            row = end;
+        }
+    }
+
+    // Linear (parallel scan), or binary, jump, interpolation and S-tree search
+    // after sorting by category
+    int countCategoryAndPayment(const std::string& category, const std::string& payment,
+                                int& categoryCount, int& paymentCount, int searchChoice, int sortChoice) {
+        return arr.countCategoryAndPayment(category, payment, categoryCount, paymentCount, searchChoice, sortChoice);
+    }
+
+    // The review index, or binary, jump, interpolation and S-tree search
+    // after sorting by rating
+    int countWordsByRating(int rating, std::vector<WordFrequency>& words, int searchChoice) {
+        return arr.countWordsByRating(rating, words, searchChoice);
+    }
+};
+
+// Singly linked list of records (linked-list.hpp), plain or unrolled
+template <bool Unrolled>
+class ListBackend {
+private:
+    LinkedList list;
+
+public:
+    ListBackend() : list(Unrolled) {}
+
+    static const char* name() { return Unrolled ? "Unrolled list" : "Linked list"; }
+
+    void addTransaction(const Transaction& t) { list.addTransaction(t); }
+    void addReview(const Review& r) { list.addReview(r); }
+    int transactionCount() const { return list.getTransactionCount(); }
+    int reviewCount() const { return list.getReviewCount(); }
+    void sortByDate(int sortChoice) { list.sortByDate(sortChoice); }
+
+    template <typename Fn>
+    void forEachDate(Fn fn) const {
+        list.forEachTransaction([&](const Transaction& t) { fn(t.date_key, t.date); });
+    }
+
+    template <typename Fn>
+    void forEachDateRun(Fn fn) const { scanDateRuns(*this, fn); }
+
+    // Linear, or binary, jump and interpolation search on the category skip
+    // list (plain list only). Nothing to sort.
+    int countCategoryAndPayment(const std::string& category, const std::string& payment,
+                                int& categoryCount, int& paymentCount, int searchChoice, int) {
+        return list.countByCategoryAndPayment(category, payment, categoryCount, paymentCount, searchChoice);
+    }
+
+    template <typename Fn>
+    void forEachReview(Fn fn) const {
+        list.forEachReview([&](const Review& r) { fn(r.rating, r.review_text); });
+    }
+
+    int countWordsByRating(int rating, std::vector<WordFrequency>& words, int) const {
+        countWordsInReviews(*this, rating, words);
+        return 1;
+    }
+};
+
+typedef ListBackend<false> LinkedListBackend;
+typedef ListBackend<true> UnrolledListBackend;
+
+// One vector per field. Dates are kept as integer keys next to their text,
+// categories and payment methods as codes into small dictionaries.
+class ColumnarBackend {
+private:
+    std::vector<std::string> customerIds;
+    std::vector<std::string> products;
+    std::vector<int> categoryCodes;
+    std::vector<double> prices;
+    std::vector<int> dateKeys;
+    std::vector<std::string> dates;
+    std::vector<int> paymentCodes;
+
+    std::vector<std::string> categoryNames;
+    std::vector<std::string> paymentNames;
+    std::unordered_map<std::string, int> categoryIds;
+    std::unordered_map<std::string, int> paymentIds;
+
+    std::vector<std::string> reviewProductIds;
+    std::vector<std::string> reviewCustomerIds;
+    std::vector<int> ratings;
+    std::vector<std::string> reviewTexts;
+
+    static int encode(const std::string& value, std::vector<std::string>& names,
+                      std::unordered_map<std::string, int>& ids) {
+        auto inserted = ids.emplace(value, static_cast<int>(names.size()));
+        if (inserted.second) names.push_back(value);
+        return inserted.first->second;
+    }
+
+    template <typename T>
+    static void permute(std::vector<T>& column, const std::vector<int>& order) {
+        std::vector<T> sorted;
+        sorted.reserve(column.size());
+        for (int row : order) sorted.push_back(std::move(column[row]));
+        column.swap(sorted);
+    }
+
+public:
+    static const char* name() { return "Columnar"; }
+
+    void addTransaction(const Transaction& t) {
+        customerIds.push_back(t.customer_id);
+        products.push_back(t.product);
+        categoryCodes.push_back(encode(t.category, categoryNames, categoryIds));
+        prices.push_back(t.price);
+        dateKeys.push_back(t.date_key);
+        dates.push_back(t.date);
+        paymentCodes.push_back(encode(t.payment_method, paymentNames, paymentIds));
+    }
+
+    void addReview(const Review& r) {
+        reviewProductIds.push_back(r.product_id);
+        reviewCustomerIds.push_back(r.customer_id);
+        ratings.push_back(r.rating);
+        reviewTexts.push_back(r.review_text);
+    }
+
+    int transactionCount() const { return static_cast<int>(dateKeys.size()); }
+    int reviewCount() const { return static_cast<int>(ratings.size()); }
+
+    // Stable-sorts row numbers by date key, whatever the choice, then gathers
+    // every column in that order
+    void sortByDate(int) {
+        std::vector<int> order(dateKeys.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = static_cast<int>(i);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return dateKeys[a] < dateKeys[b]; });
+        permute(customerIds, order);
+        permute(products, order);
+        permute(categoryCodes, order);
+        permute(prices, order);
+        permute(dateKeys, order);
+        permute(dates, order);
+        permute(paymentCodes, order);
+    }
+
+    template <typename Fn>
+    void forEachDate(Fn fn) const {
+        for (size_t i = 0; i < dateKeys.size(); i++) fn(dateKeys[i], dates[i]);
+    }
+
+    template <typename Fn>
+    void forEachDateRun(Fn fn) const { scanDateRuns(*this, fn); }
+
+    // Linear scan of the two code columns
+    int countCategoryAndPayment(const std::string& category, const std::string& payment,
+                                int& categoryCount, int& paymentCount, int, int) {
+        categoryCount = 0;
+        paymentCount = 0;
+        auto categoryId = categoryIds.find(category);
+        if (categoryId == categoryIds.end()) return 1;
+        auto paymentId = paymentIds.find(payment);
+        int paymentCode = paymentId == paymentIds.end() ? -1 : paymentId->second;
+        for (size_t i = 0; i < categoryCodes.size(); i++) {
+            if (categoryCodes[i] == categoryId->second) {
+                categoryCount++;
+                if (paymentCodes[i] == paymentCode) paymentCount++;
+            }
+        }
+        return 1;
+    }
+
+    template <typename Fn>
+    void forEachReview(Fn fn) const {
+        for (size_t i = 0; i < ratings.size(); i++) fn(ratings[i], reviewTexts[i]);
+    }
+
+    int countWordsByRating(int rating, std::vector<WordFrequency>& words, int) const {
+        countWordsInReviews(*this, rating, words);
+        return 1;
+    }
+};
+
+// One line of the Q1 answer
+struct DateCount {
+    int key;            // YYYYMMDD
+    std::string date;   // as the first transaction of that date wrote it
+    int count;
+};
+
+// Loading and Q1-Q3 written once over a storage backend, so every backend
+// gets the same input normalization and the same answers.
+template <typename Backend>
+class DataStore {
+private:
+    Backend backend;
+
+    static std::string lowercase(std::string text) {
+        for (char& c : text) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return text;
+    }
+
+    // By count, highest first, then alphabetically
+    static bool moreFrequent(const WordFrequency& a, const WordFrequency& b) {
+        return a.count != b.count ? a.count > b.count : a.word < b.word;
+    }
+
+    // Ranks words with the chosen sort (1-4 = bubble, insertion, selection, merge)
+    static void rankWords(std::vector<WordFrequency>& words, int sortChoice) {
+        int n = static_cast<int>(words.size());
+        if (sortChoice == 1) {
+            for (int i = 0; i < n - 1; i++) {
+                for (int j = 0; j < n - i - 1; j++) {
+                    if (moreFrequent(words[j + 1], words[j])) std::swap(words[j], words[j + 1]);
+                }
+            }
+        } else if (sortChoice == 2) {
+            for (int i = 1; i < n; i++) {
+                WordFrequency key = words[i];
+                int j = i - 1;
+                while (j >= 0 && moreFrequent(key, words[j])) {
+                    words[j + 1] = words[j];
+                    j--;
+                }
+                words[j + 1] = key;
+            }
+        } else if (sortChoice == 3) {
+            for (int i = 0; i < n - 1; i++) {
+                int best = i;
+                for (int j = i + 1; j < n; j++) {
+                    if (moreFrequent(words[j], words[best])) best = j;
+                }
+                if (best != i) std::swap(words[i], words[best]);
+            }
+        } else {
+            std::stable_sort(words.begin(), words.end(), moreFrequent);
+        }
+    }
+
+    static long long millisecondsSince(std::chrono::high_resolution_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+public:
+    static const char* name() { return Backend::name(); }
+    Backend& storage() { return backend; }
+
+    static const char* sortName(int sortChoice) {
+        static const char* names[] = {"Bubble Sort", "Insertion Sort", "Selection Sort", "Merge Sort"};
+        return (sortChoice >= 1 && sortChoice <= 4) ? names[sortChoice - 1] : "Merge Sort";
+    }
+
+    static const char* searchName(int searchChoice) {
+        static const char* names[] = {"Linear Search", "Binary Search", "Jump Search",
+                                      "Interpolation Search", "S-Tree Search"};
+        return (searchChoice >= 1 && searchChoice <= 5) ? names[searchChoice - 1] : "Linear Search";
+    }
+
+    // Fields are trimmed, category and payment lowercased and the date keyed
+    // as YYYYMMDD. Malformed rows are skipped and reported.
+    bool loadTransactions(const std::string& filename) {
+        CsvReader csv;
+        if (!csv.open(filename)) return false;
+        csv.nextRow(); // Skip header
+        while (csv.nextRow()) {
+            if (csv.fieldCount() != 6) csv.reportError("expected 6 fields, found " + std::to_string(csv.fieldCount()));
+            Transaction t;
+            if (csv.rowValid() && !parseCsvDouble(csv.field(3), t.price)) csv.reportError("invalid price");
+            if (csv.rowValid()) {
+                t.date = csv.field(4).trimmed().str();
+                t.date_key = dateSortKey(t.date);
+                if (t.date_key == 0) csv.reportError("invalid date");
+            }
+            if (!csv.rowValid()) continue;
+            t.customer_id = csv.field(0).trimmed().str();
+            t.product = csv.field(1).trimmed().str();
+            t.category = lowercase(csv.field(2).trimmed().str());
+            t.payment_method = lowercase(csv.field(5).trimmed().str());
+            backend.addTransaction(t);
+        }
+        printCsvErrors(filename, csv.errors());
+        return true;
+    }
+
+    bool loadReviews(const std::string& filename) {
+        CsvReader csv;
+        if (!csv.open(filename)) return false;
+        csv.nextRow(); // Skip header
+        while (csv.nextRow()) {
+            if (csv.fieldCount() != 4) csv.reportError("expected 4 fields, found " + std::to_string(csv.fieldCount()));
+            Review r;
+            if (csv.rowValid() && !parseCsvInt(csv.field(2), r.rating)) csv.reportError("invalid rating");
+            if (!csv.rowValid()) continue;
+            r.product_id = csv.field(0).trimmed().str();
+            r.customer_id = csv.field(1).trimmed().str();
+            r.review_text = csv.field(3).trimmed().str();
+            backend.addReview(r);
+        }
+        printCsvErrors(filename, csv.errors());
+        return true;
+    }
+
+    // Q1: sorts by date with the chosen sort and returns the transactions per
+    // date, in date order
+    std::vector<DateCount> countTransactionsByDate(int sortChoice = 4) {
+        backend.sortByDate(sortChoice);
+        std::vector<DateCount> counts;
+        backend.forEachDateRun([&](int key, const std::string& date, int count) {
+            counts.push_back(DateCount{key, date, count});
+        });
+        return counts;
+    }
+
+    // Q2: electronics purchases and, of those, the ones paid by credit card.
+    // Returns the search used (see countCategoryAndPayment above).
+    int countElectronicsCreditCard(int& electronics, int& creditCard, int searchChoice = 1, int sortChoice = 4) {
+        return backend.countCategoryAndPayment("electronics", "credit card", electronics, creditCard,
+                                               searchChoice, sortChoice);
+    }
+
+    // Q3: the top most frequent words in 1-star reviews, by count then word.
+    // Returns the search used (see countWordsByRating above).
+    int frequentWordsInOneStarReviews(int top, std::vector<WordFrequency>& words,
+                                      int searchChoice = 1, int sortChoice = 4) {
+        words.clear();
+        int searchUsed = backend.countWordsByRating(1, words, searchChoice);
+        rankWords(words, sortChoice);
+        if (static_cast<int>(words.size()) > top) words.resize(top);
+        return searchUsed;
+    }
+
+    // Runs Q1-Q3 for the menus: times the question, then prints the
+    // algorithms used and the answer
+    void runQuestion(int question, int searchChoice, int sortChoice) {
+        if (question < 1 || question > 3) return;
+        if (sortChoice < 1 || sortChoice > 4) {
+            std::cout << "Invalid sort choice. Using Merge Sort.\n";
+            sortChoice = 4;
+        }
+        auto reportSearch = [&](int searchUsed) {
+            if (searchUsed != searchChoice) {
+                std::cout << "Search choice " << searchChoice << " is not available for " << name()
+                          << "; using choice " << searchUsed << ".\n";
+            }
+        };
+        auto start = std::chrono::high_resolution_clock::now();
+        if (question == 1) {
+            std::vector<DateCount> counts = countTransactionsByDate(sortChoice);
+            long long duration_ms = millisecondsSince(start);
+            std::cout << "[" << sortName(sortChoice) << "] Execution time: " << duration_ms << " ms\n";
+            std::cout << "Total transactions: " << backend.transactionCount() << "\n";
+            std::cout << "Total reviews: " << backend.reviewCount() << "\n";
+            std::cout << "\nTransaction Counts by Date:\n";
+            for (const DateCount& c : counts) std::cout << c.date << ": " << c.count << " transactions\n";
+        } else if (question == 2) {
+            int electronics = 0, creditCard = 0;
+            int searchUsed = countElectronicsCreditCard(electronics, creditCard, searchChoice, sortChoice);
+            long long duration_ms = millisecondsSince(start);
+            reportSearch(searchUsed);
+            double percentage = electronics > 0 ? static_cast<double>(creditCard) / electronics * 100.0 : 0.0;
+            std::cout << "[" << searchName(searchUsed) << "] Execution time: " << duration_ms << " ms\n";
+            std::cout << "Total Electronics Purchases: " << electronics << "\n";
+            std::cout << "Electronics Purchases with Credit Card: " << creditCard << "\n";
+            std::cout << "Percentage: " << std::fixed << std::setprecision(2) << percentage << "%\n";
+        } else {
+            std::vector<WordFrequency> words;
+            int searchUsed = frequentWordsInOneStarReviews(10, words, searchChoice, sortChoice);
+            long long duration_ms = millisecondsSince(start);
+            reportSearch(searchUsed);
+            // Search 1 is the default way each backend finds the reviews, not named here
+            if (searchUsed != 1) std::cout << "[" << searchName(searchUsed) << "] ";
+            std::cout << "[" << sortName(sortChoice) << "] Execution time: " << duration_ms << " ms\n";
+            std::cout << "Top " << words.size() << " frequent words in 1-star reviews:\n";
+            for (const WordFrequency& w : words) std::cout << w.word << ": " << w.count << "\n";
+        }
+    }
+};
+
+#endif // DATASTORE_HPP
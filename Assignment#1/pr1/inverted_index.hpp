@@ -0,0 +1,172 @@
+#ifndef INVERTED_INDEX_HPP
+#define INVERTED_INDEX_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <iterator>
+#include <cctype>
+#include <cstdint>
+
+const int INDEX_MAX_RATING = 5;
+
+// Splits text into lowercase alphanumeric words, the same way Q3 does.
+template <typename OnWord>
+void forEachWord(const std::string& text, OnWord on_word) {
+    std::string word;
+    for (char c : text) {
+        unsigned char uc = static_cast<unsigned char>(c);
+        if (std::isalnum(uc)) word += static_cast<char>(std::tolower(uc));
+        else if (!word.empty()) {
+            on_word(word);
+            word.clear();
+        }
+    }
+    if (!word.empty()) on_word(word);
+}
+
+// Inverted index over review text: word -> rows of the reviews that contain it.
+// Posting lists store the gaps between ascending row numbers as varints, so
+// common words cost about one byte per review. Each word also keeps how many
+// times it occurs in reviews of each rating.
+class ReviewIndex {
+private:
+    struct TermEntry {
+        std::string term;
+        std::vector<uint8_t> postings;
+        int review_count;
+        int last_row;
+        int count_by_rating[INDEX_MAX_RATING + 1];  // [0] = ratings outside 1..5
+    };
+
+    std::unordered_map<std::string, int> term_ids;
+    std::vector<TermEntry> terms;   // in order of first appearance
+    int indexed_reviews;
+
+    static void appendVarint(std::vector<uint8_t>& out, uint32_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    static std::vector<int> decode(const TermEntry& entry) {
+        std::vector<int> rows;
+        rows.reserve(entry.review_count);
+        int row = 0;
+        size_t i = 0;
+        while (i < entry.postings.size()) {
+            uint32_t gap = 0;
+            int shift = 0;
+            uint8_t byte;
+            do {
+                byte = entry.postings[i++];
+                gap |= static_cast<uint32_t>(byte & 0x7F) << shift;
+                shift += 7;
+            } while (byte & 0x80);
+            row += static_cast<int>(gap);
+            rows.push_back(row);
+        }
+        return rows;
+    }
+
+    const TermEntry* find(const std::string& term) const {
+        std::string key;
+        forEachWord(term, [&](const std::string& w) { if (key.empty()) key = w; });
+        auto it = term_ids.find(key);
+        return it == term_ids.end() ? nullptr : &terms[it->second];
+    }
+
+    // Decoded posting lists for the given terms; an unknown term gives an empty list
+    std::vector<std::vector<int>> postingLists(const std::vector<std::string>& query) const {
+        std::vector<std::vector<int>> lists;
+        for (const std::string& term : query) {
+            const TermEntry* entry = find(term);
+            lists.push_back(entry ? decode(*entry) : std::vector<int>());
+        }
+        return lists;
+    }
+
+public:
+    ReviewIndex() : indexed_reviews(0) {}
+
+    // text_at(i) and rating_at(i) give the text and rating of review row i.
+    template <typename TextAt, typename RatingAt>
+    void build(int n, TextAt text_at, RatingAt rating_at) {
+        term_ids.clear();
+        terms.clear();
+        indexed_reviews = n;
+        for (int row = 0; row < n; row++) {
+            int rating = rating_at(row);
+            int bucket = (rating >= 1 && rating <= INDEX_MAX_RATING) ? rating : 0;
+            forEachWord(text_at(row), [&](const std::string& word) {
+                auto inserted = term_ids.emplace(word, static_cast<int>(terms.size()));
+                if (inserted.second) {
+                    TermEntry entry;
+                    entry.term = word;
+                    entry.review_count = 0;
+                    entry.last_row = 0;
+                    for (int r = 0; r <= INDEX_MAX_RATING; r++) entry.count_by_rating[r] = 0;
+                    terms.push_back(entry);
+                }
+                TermEntry& entry = terms[inserted.first->second];
+                entry.count_by_rating[bucket]++;
+                if (entry.review_count == 0 || entry.last_row != row) {
+                    appendVarint(entry.postings, static_cast<uint32_t>(row - entry.last_row));
+                    entry.last_row = row;
+                    entry.review_count++;
+                }
+            });
+        }
+    }
+
+    int reviewCount() const { return indexed_reviews; }
+    int termCount() const { return static_cast<int>(terms.size()); }
+    const std::string& termAt(int id) const { return terms[id].term; }
+    int occurrencesAt(int id, int rating) const {
+        return (rating >= 0 && rating <= INDEX_MAX_RATING) ? terms[id].count_by_rating[rating] : 0;
+    }
+
+    // Occurrences of term in reviews with the given rating
+    int occurrences(const std::string& term, int rating) const {
+        const TermEntry* entry = find(term);
+        return (entry && rating >= 0 && rating <= INDEX_MAX_RATING) ? entry->count_by_rating[rating] : 0;
+    }
+
+    // Rows of the reviews that mention term, ascending
+    std::vector<int> reviewsMentioning(const std::string& term) const {
+        const TermEntry* entry = find(term);
+        return entry ? decode(*entry) : std::vector<int>();
+    }
+
+    // Rows of the reviews that mention every term (AND), ascending
+    std::vector<int> reviewsMentioningAll(const std::vector<std::string>& query) const {
+        if (query.empty()) return std::vector<int>();
+        std::vector<std::vector<int>> lists = postingLists(query);
+        std::sort(lists.begin(), lists.end(),
+                  [](const std::vector<int>& a, const std::vector<int>& b) { return a.size() < b.size(); });
+        std::vector<int> result = lists[0];
+        for (size_t l = 1; l < lists.size() && !result.empty(); l++) {
+            std::vector<int> next;
+            std::set_intersection(result.begin(), result.end(), lists[l].begin(), lists[l].end(),
+                                  std::back_inserter(next));
+            result.swap(next);
+        }
+        return result;
+    }
+
+    // Rows of the reviews that mention at least one term (OR), ascending
+    std::vector<int> reviewsMentioningAny(const std::vector<std::string>& query) const {
+        std::vector<int> result;
+        for (const std::vector<int>& list : postingLists(query)) {
+            std::vector<int> next;
+            std::set_union(result.begin(), result.end(), list.begin(), list.end(), std::back_inserter(next));
+            result.swap(next);
+        }
+        return result;
+    }
+};
+
+#endif // INVERTED_INDEX_HPP
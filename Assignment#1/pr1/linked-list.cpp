@@ -1,74 +1,230 @@
 #include "linked-list.hpp"
+#include "datastore.hpp"
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <string>
 #include <vector>
 #include <chrono>
-#include <map>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <random>
+#include <functional>
+#include <iomanip>
+#include <cstdio>
 
-// Helper function implementation
-std::string standardizeDate(const std::string& date) {
-    // Implementation would go here
-    // For now, just return the date as is
-    return date;
+// Position of one record in an unrolled list
+struct BlockCursor {
+    TransactionBlock* block;
+    int index;
+
+    Transaction& item() const { return block->items[index]; }
+    int& key() const { return block->dateKeys[index]; }
+    // Exchanges the records (and keys) at two positions
+    void swapWith(const BlockCursor& other) const {
+        std::swap(item(), other.item());
+        std::swap(key(), other.key());
+    }
+    bool valid() const { return block != nullptr; }
+    void advance() {
+        if (++index == block->count) {
+            block = block->next;
+            index = 0;
+        }
+    }
+    bool operator==(const BlockCursor& other) const { return block == other.block && index == other.index; }
+    bool operator!=(const BlockCursor& other) const { return !(*this == other); }
+};
+
+// UnrolledTransactionList implementation
+UnrolledTransactionList::UnrolledTransactionList() : head(nullptr), tail(nullptr), count(0) {}
+
+void UnrolledTransactionList::append(const Transaction& t) {
+    if (tail == nullptr || tail->count == UNROLLED_BLOCK_SIZE) {
+        TransactionBlock* block = blockPool.create();
+        if (head == nullptr) head = block;
+        else tail->next = block;
+        tail = block;
+    }
+    tail->items[tail->count] = t;
+    tail->dateKeys[tail->count] = t.date_key;
+    tail->count++;
+    count++;
 }
 
-// LinkedList class implementation
-LinkedList::LinkedList() : transactionHead(nullptr), reviewHead(nullptr), transactionCount(0), reviewCount(0) {}
+void UnrolledTransactionList::insertAfter(TransactionBlock* block, int index, const Transaction& t) {
+    if (block->count == UNROLLED_BLOCK_SIZE) {
+        // Split: the upper half moves to a new block linked right after this one
+        TransactionBlock* upper = blockPool.create();
+        int half = UNROLLED_BLOCK_SIZE / 2;
+        for (int i = half; i < block->count; i++) {
+            upper->items[i - half] = std::move(block->items[i]);
+            upper->dateKeys[i - half] = block->dateKeys[i];
+        }
+        upper->count = block->count - half;
+        block->count = half;
+        upper->next = block->next;
+        block->next = upper;
+        if (tail == block) tail = upper;
+        if (index >= half) {
+            block = upper;
+            index -= half;
+        }
+    }
+    for (int i = block->count; i > index + 1; i--) {
+        block->items[i] = std::move(block->items[i - 1]);
+        block->dateKeys[i] = block->dateKeys[i - 1];
+    }
+    block->items[index + 1] = t;
+    block->dateKeys[index + 1] = t.date_key;
+    block->count++;
+    count++;
+}
 
-LinkedList::~LinkedList() {
-    // Clean up transaction nodes
-    TransactionNode* currentT = transactionHead;
-    while (currentT != nullptr) {
-        TransactionNode* temp = currentT;
-        currentT = currentT->next;
-        delete temp;
+void UnrolledTransactionList::sortByDate(int sortChoice) {
+    if (sortChoice == 1) {
+        bubbleSortByDate();
+    } else if (sortChoice == 2) {
+        insertionSortByDate();
+    } else if (sortChoice == 3) {
+        selectionSortByDate();
+    } else if (sortChoice == 4) {
+        mergeSortByDate();
     }
-    
-    // Clean up review nodes
-    ReviewNode* currentR = reviewHead;
-    while (currentR != nullptr) {
-        ReviewNode* temp = currentR;
-        currentR = currentR->next;
-        delete temp;
+}
+
+void UnrolledTransactionList::bubbleSortByDate() {
+    for (int pass = 0; pass < count - 1; pass++) {
+        bool swapped = false;
+        BlockCursor current{head, 0};
+        for (int i = 0; i < count - pass - 1; i++) {
+            BlockCursor next = current;
+            next.advance();
+            if (current.key() > next.key()) {
+                current.swapWith(next);
+                swapped = true;
+            }
+            current = next;
+        }
+        if (!swapped) break;
     }
 }
 
+void UnrolledTransactionList::insertionSortByDate() {
+    // No back links, so each record is carried forward from its insertion point
+    BlockCursor current{head, 0};
+    for (int i = 0; i < count; i++, current.advance()) {
+        BlockCursor pos{head, 0};
+        while (pos != current && pos.key() <= current.key()) pos.advance();
+        if (pos == current) continue;
+        Transaction carried = std::move(current.item());
+        int carriedKey = current.key();
+        while (pos != current) {
+            std::swap(carried, pos.item());
+            std::swap(carriedKey, pos.key());
+            pos.advance();
+        }
+        current.item() = std::move(carried);
+        current.key() = carriedKey;
+    }
+}
+
+void UnrolledTransactionList::selectionSortByDate() {
+    if (head == nullptr) return;
+    for (BlockCursor current{head, 0}; current.valid(); current.advance()) {
+        BlockCursor min = current;
+        BlockCursor r = current;
+        for (r.advance(); r.valid(); r.advance()) {
+            if (r.key() < min.key()) min = r;
+        }
+        if (min != current) current.swapWith(min);
+    }
+}
+
+void UnrolledTransactionList::mergeSortByDate() {
+    // Blocks are arrays, so (key, position) pairs are merge-sorted as one array
+    // and the records written back in that order, leaving every block but the
+    // last full
+    std::vector<Transaction> items;
+    std::vector<std::pair<int, int>> order;
+    items.reserve(count);
+    order.reserve(count);
+    for (TransactionBlock* b = head; b != nullptr; b = b->next) {
+        for (int i = 0; i < b->count; i++) {
+            order.push_back(std::make_pair(b->dateKeys[i], static_cast<int>(items.size())));
+            items.push_back(std::move(b->items[i]));
+        }
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.first < b.first; });
+    TransactionBlock* block = head;
+    size_t k = 0;
+    while (k < order.size()) {
+        block->count = 0;
+        while (block->count < UNROLLED_BLOCK_SIZE && k < order.size()) {
+            block->dateKeys[block->count] = order[k].first;
+            block->items[block->count++] = std::move(items[order[k].second]);
+            k++;
+        }
+        tail = block;
+        block = block->next;
+    }
+    if (tail != nullptr) tail->next = nullptr;
+}
+
+// LinkedList class implementation
+LinkedList::LinkedList(bool unrolledStorage) : transactionHead(nullptr), transactionTail(nullptr), reviewHead(nullptr),
+                                               reviewTail(nullptr), transactionCount(0), reviewCount(0),
+                                               unrolled(unrolledStorage),
+                                               categoryIndex(&Transaction::category), dateIndex(&Transaction::date_key),
+                                               skipIndexesValid(false), autoCompact(true) {}
+
+// Nodes belong to the pools, which release them when the list is destroyed
+LinkedList::~LinkedList() {}
+
 void LinkedList::addTransaction(const Transaction& t) {
-    TransactionNode* newNode = new TransactionNode(t);
+    if (unrolled) {
+        unrolledTransactions.append(t);
+        transactionCount++;
+        return;
+    }
+    TransactionNode* newNode = transactionPool.create(t);
     if (transactionHead == nullptr) {
         transactionHead = newNode;
     } else {
-        TransactionNode* current = transactionHead;
-        while (current->next != nullptr) {
-            current = current->next;
-        }
-        current->next = newNode;
+        transactionTail->next = newNode;
+    }
+    transactionTail = newNode;
+    if (skipIndexesValid) {
+        categoryIndex.insert(&newNode->data);
+        dateIndex.insert(&newNode->data);
     }
     transactionCount++;
 }
 
 void LinkedList::addReview(const Review& r) {
-    ReviewNode* newNode = new ReviewNode(r);
+    ReviewNode* newNode = reviewPool.create(r);
     if (reviewHead == nullptr) {
         reviewHead = newNode;
     } else {
-        ReviewNode* current = reviewHead;
-        while (current->next != nullptr) {
-            current = current->next;
-        }
-        current->next = newNode;
+        reviewTail->next = newNode;
     }
+    reviewTail = newNode;
     reviewCount++;
 }
 
-void LinkedList::sortTransactionsByDate(int sortChoice, long long& duration_ms) {
-    auto start = std::chrono::high_resolution_clock::now();
-    
-    if (sortChoice == 1) {
+void LinkedList::updateTransactionTail() {
+    transactionTail = transactionHead;
+    while (transactionTail != nullptr && transactionTail->next != nullptr) {
+        transactionTail = transactionTail->next;
+    }
+}
+
+void LinkedList::sortByDate(int sortChoice) {
+    skipIndexesValid = false;
+    if (unrolled) {
+        unrolledTransactions.sortByDate(sortChoice);
+    } else if (sortChoice == 1) {
         // Bubble Sort
         bubbleSortTransactions();
     } else if (sortChoice == 2) {
@@ -81,37 +237,36 @@ void LinkedList::sortTransactionsByDate(int sortChoice, long long& duration_ms)
         // Merge Sort
         transactionHead = mergeSortTransactions(transactionHead);
     }
-    
-    auto end = std::chrono::high_resolution_clock::now();
-    duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-    
-    // Display results
-    std::cout << "\nSorting completed in " << duration_ms << " ms\n";
-    countTransactionsByDate();
+    updateTransactionTail();
+    if (autoCompact && !unrolled && transactionCount >= COMPACT_AFTER_SORT_MIN_NODES) {
+        compact();
+    }
 }
 
 void LinkedList::bubbleSortTransactions() {
     if (transactionHead == nullptr || transactionHead->next == nullptr) return;
     
     bool swapped;
-    TransactionNode* current;
     TransactionNode* last = nullptr;
     
     do {
         swapped = false;
-        current = transactionHead;
+        // link is the pointer that refers to the current node, so a swap can relink it
+        TransactionNode** link = &transactionHead;
         
-        while (current->next != last) {
-            if (current->data.date > current->next->data.date) {
-                // Swap data (not nodes)
-                Transaction temp = current->data;
-                current->data = current->next->data;
-                current->next->data = temp;
+        while ((*link)->next != last) {
+            TransactionNode* current = *link;
+            TransactionNode* next = current->next;
+            if (current->dateKey > next->dateKey) {
+                // Swap nodes by relinking, the records stay where they are
+                current->next = next->next;
+                next->next = current;
+                *link = next;
                 swapped = true;
             }
-            current = current->next;
+            link = &(*link)->next;
         }
-        last = current;
+        last = *link;
     } while (swapped);
 }
 
@@ -124,12 +279,12 @@ void LinkedList::insertionSortTransactions() {
     while (current != nullptr) {
         TransactionNode* next = current->next;
         
-        if (sorted == nullptr || sorted->data.date >= current->data.date) {
+        if (sorted == nullptr || sorted->dateKey >= current->dateKey) {
             current->next = sorted;
             sorted = current;
         } else {
             TransactionNode* search = sorted;
-            while (search->next != nullptr && search->next->data.date < current->data.date) {
+            while (search->next != nullptr && search->next->dateKey < current->dateKey) {
                 search = search->next;
             }
             current->next = search->next;
@@ -145,364 +300,376 @@ void LinkedList::insertionSortTransactions() {
 void LinkedList::selectionSortTransactions() {
     if (transactionHead == nullptr || transactionHead->next == nullptr) return;
     
-    TransactionNode* current = transactionHead;
+    // Unlink the earliest remaining node and append it to the sorted list
+    TransactionNode* sorted = nullptr;
+    TransactionNode* sortedTail = nullptr;
     
-    while (current != nullptr) {
-        TransactionNode* min = current;
-        TransactionNode* r = current->next;
-        
-        while (r != nullptr) {
-            if (r->data.date < min->data.date) {
-                min = r;
+    while (transactionHead != nullptr) {
+        TransactionNode** minLink = &transactionHead;
+        for (TransactionNode** link = &transactionHead->next; *link != nullptr; link = &(*link)->next) {
+            if ((*link)->dateKey < (*minLink)->dateKey) {
+                minLink = link;
             }
-            r = r->next;
         }
         
-        if (min != current) {
-            // Swap data (not nodes)
-            Transaction temp = current->data;
-            current->data = min->data;
-            min->data = temp;
-        }
-        
-        current = current->next;
+        TransactionNode* min = *minLink;
+        *minLink = min->next;
+        min->next = nullptr;
+        if (sortedTail == nullptr) sorted = min;
+        else sortedTail->next = min;
+        sortedTail = min;
     }
+    
+    transactionHead = sorted;
 }
 
-TransactionNode* LinkedList::mergeSortTransactions(TransactionNode* head) {
-    // Base case
-    if (head == nullptr || head->next == nullptr) {
-        return head;
+void LinkedList::compact() {
+    if (unrolled || transactionHead == nullptr) return;
+    NodePool<TransactionNode> fresh;
+    TransactionNode* newHead = nullptr;
+    TransactionNode* newTail = nullptr;
+    for (TransactionNode* current = transactionHead; current != nullptr; current = current->next) {
+        TransactionNode* copy = fresh.create(std::move(current->data), current->dateKey);
+        if (newTail == nullptr) newHead = copy;
+        else newTail->next = copy;
+        newTail = copy;
     }
-    
-    // Split the list into two halves
-    TransactionNode* middle = getMiddle(head);
-    TransactionNode* nextOfMiddle = middle->next;
-    middle->next = nullptr;
-    
-    // Recursively sort both lists
-    TransactionNode* left = mergeSortTransactions(head);
-    TransactionNode* right = mergeSortTransactions(nextOfMiddle);
-    
-    // Merge the sorted lists
-    TransactionNode* sortedList = sortedMerge(left, right);
-    return sortedList;
+    transactionHead = newHead;
+    transactionTail = newTail;
+    transactionPool.swap(fresh);   // the old nodes are freed with fresh
+    skipIndexesValid = false;      // the indexes point at the old nodes
 }
 
-TransactionNode* LinkedList::getMiddle(TransactionNode* head) {
+TransactionNode* LinkedList::mergeSortTransactions(TransactionNode* head) {
+    // Natural bottom-up merge sort. Each pass merges neighbouring ascending runs
+    // pairwise, so the number of runs halves per pass; already ordered input is
+    // one run and finishes after a single scan. No recursion, O(1) extra space.
     if (head == nullptr) return head;
-    
-    TransactionNode* slow = head;
-    TransactionNode* fast = head->next;
-    
-    while (fast != nullptr) {
-        fast = fast->next;
-        if (fast != nullptr) {
-            slow = slow->next;
-            fast = fast->next;
+    int runs;
+    do {
+        TransactionNode* sorted = nullptr;
+        TransactionNode* sortedTail = nullptr;
+        TransactionNode* rest = head;
+        runs = 0;
+        while (rest != nullptr) {
+            TransactionNode* first = rest;
+            TransactionNode* second = cutRun(first);
+            TransactionNode* runHead = first;
+            TransactionNode* runTail = nullptr;
+            rest = nullptr;
+            if (second != nullptr) {
+                rest = cutRun(second);
+                runHead = sortedMerge(first, second, runTail);
+            }
+            if (sortedTail == nullptr) sorted = runHead;
+            else sortedTail->next = runHead;
+            sortedTail = runTail;
+            runs++;
         }
+        head = sorted;
+    } while (runs > 1);
+    return head;
+}
+TransactionNode* LinkedList::cutRun(TransactionNode* head) {
+    while (head->next != nullptr && head->dateKey <= head->next->dateKey) {
+        head = head->next;
     }
-    return slow;
+    TransactionNode* rest = head->next;
+    head->next = nullptr;
+    return rest;
 }
-
-TransactionNode* LinkedList::sortedMerge(TransactionNode* a, TransactionNode* b) {
-    TransactionNode* result = nullptr;
-    
-    // Base cases
-    if (a == nullptr) return b;
-    if (b == nullptr) return a;
-    
-    // Pick smaller value
-    if (a->data.date <= b->data.date) {
-        result = a;
-        result->next = sortedMerge(a->next, b);
+TransactionNode* LinkedList::sortedMerge(TransactionNode* a, TransactionNode* b, TransactionNode*& tail) {
+    // Ties take from a, so the sort stays stable
+    TransactionNode* head;
+    if (a->dateKey <= b->dateKey) {
+        head = a;
+        a = a->next;
     } else {
-        result = b;
-        result->next = sortedMerge(a, b->next);
+        head = b;
+        b = b->next;
     }
-    return result;
+    tail = head;
+    while (a != nullptr && b != nullptr) {
+        if (a->dateKey <= b->dateKey) {
+            tail->next = a;
+            a = a->next;
+        } else {
+            tail->next = b;
+            b = b->next;
+        }
+        tail = tail->next;
+    }
+    tail->next = a != nullptr ? a : b;
+    while (tail->next != nullptr) tail = tail->next;
+    return head;
 }
 
-void LinkedList::countTransactionsByDate() {
-    std::map<std::string, int> dateCounts;
-    TransactionNode* current = transactionHead;
-    
-    while (current != nullptr) {
-        dateCounts[current->data.date]++;
-        current = current->next;
+void LinkedList::ensureSkipIndexes() {
+    if (skipIndexesValid) return;
+    categoryIndex.clear();
+    dateIndex.clear();
+    for (TransactionNode* current = transactionHead; current != nullptr; current = current->next) {
+        categoryIndex.insert(&current->data);
+        dateIndex.insert(&current->data);
     }
-    
-    std::cout << "\nTransaction Counts by Date:\n";
-    for (const auto& pair : dateCounts) {
-        std::cout << pair.first << ": " << pair.second << " transactions\n";
+    skipIndexesValid = true;
+}
+
+int LinkedList::countTransactionsInDateRange(int from, int to) {
+    int count = 0;
+    if (unrolled) {
+        forEachTransaction([&](const Transaction& t) {
+            if (t.date_key >= from && t.date_key <= to) count++;
+        });
+        return count;
     }
+    ensureSkipIndexes();
+    if (to < from) return 0;
+    return dateIndex.countBelow(to, true) - dateIndex.countBelow(from);
 }
 
-void LinkedList::calculateElectronicsCreditCardPercentage(int searchChoice, int sortChoice, long long& duration_ms) {
-    auto start = std::chrono::high_resolution_clock::now();
-    
-    int totalElectronics = 0;
-    int electronicsCreditCard = 0;
-    std::vector<Transaction> electronicsTransactions;
-    
-    // First use search algorithm to find Electronics transactions
-    if (searchChoice == 1) {
-        // Linear Search
-        TransactionNode* current = transactionHead;
-        while (current != nullptr) {
-            if (current->data.category == "Electronics") {
-                electronicsTransactions.push_back(current->data);
-                totalElectronics++;
-                if (current->data.payment_method == "Credit Card") {
-                    electronicsCreditCard++;
-                }
-            }
-            current = current->next;
+int LinkedList::countByCategoryAndPayment(const std::string& category, const std::string& payment,
+                                          int& categoryCount, int& paymentCount, int searchChoice) {
+    categoryCount = 0;
+    paymentCount = 0;
+    auto count = [&](const Transaction& t) {
+        categoryCount++;
+        if (t.payment_method == payment) paymentCount++;
+    };
+    if (searchChoice >= 2 && searchChoice <= 4 && !unrolled) {
+        // The category skip list finds the first entry of the category; the
+        // rest follow it on level 0, in list order
+        ensureSkipIndexes();
+        SkipListIndex<Transaction>::Entry* entry;
+        if (searchChoice == 2) {
+            entry = categoryIndex.lowerBound(category);
+        } else if (searchChoice == 3) {
+            entry = categoryIndex.jumpSearch(category);
+        } else {
+            entry = categoryIndex.interpolationSearch(category);
         }
-    } else {
-        // For other search methods in a linked list, we would need to
-        // convert to a vector first, which defeats the purpose of using linked list
-        // So we'll use linear search for all cases
-        std::cout << "\nNote: Linked lists are best suited for linear search. "
-                << "Other search methods require conversion to arrays.\n";
-        
-        TransactionNode* current = transactionHead;
-        while (current != nullptr) {
-            if (current->data.category == "Electronics") {
-                electronicsTransactions.push_back(current->data);
-                totalElectronics++;
-                if (current->data.payment_method == "Credit Card") {
-                    electronicsCreditCard++;
-                }
-            }
-            current = current->next;
+        for (; entry != nullptr && entry->record->category == category; entry = entry->next()) {
+            count(*entry->record);
         }
+        return searchChoice;
     }
-    
-    // Now sort the electronics transactions by price
-    if (sortChoice == 1) {
-        // Bubble Sort
-        for (size_t i = 0; i < electronicsTransactions.size(); i++) {
-            for (size_t j = 0; j < electronicsTransactions.size() - i - 1; j++) {
-                if (electronicsTransactions[j].price > electronicsTransactions[j + 1].price) {
-                    std::swap(electronicsTransactions[j], electronicsTransactions[j + 1]);
-                }
-            }
-        }
-    } else if (sortChoice == 2) {
-        // Insertion Sort
-        for (size_t i = 1; i < electronicsTransactions.size(); i++) {
-            auto key = electronicsTransactions[i];
-            int j = i - 1;
-            while (j >= 0 && electronicsTransactions[j].price > key.price) {
-                electronicsTransactions[j + 1] = electronicsTransactions[j];
-                j--;
-            }
-            electronicsTransactions[j + 1] = key;
+    forEachTransaction([&](const Transaction& t) {
+        if (t.category == category) count(t);
+    });
+    return 1;
+}
+
+// Times building, a category/payment filter scan and a full traversal over n
+// generated transactions for the plain list, the unrolled list and a contiguous
+// array of the same records.
+void runStorageBenchmark(int n) {
+    static const char* CATEGORIES[] = {"Electronics", "Fashion", "Home & Kitchen", "Sports", "Books", "Toys"};
+    static const char* PAYMENTS[] = {"Credit Card", "Debit Card", "PayPal", "Cash on Delivery", "Bank Transfer"};
+    const int RUNS = 5;   // best of RUNS for the scans
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> day(1, 28), month(1, 12), year(2020, 2024);
+    std::uniform_real_distribution<double> price(5.0, 2000.0);
+    std::vector<Transaction> rows(n);
+    for (int i = 0; i < n; i++) {
+        char date[11];
+        std::snprintf(date, sizeof(date), "%02d/%02d/%04d", day(rng), month(rng), year(rng));
+        rows[i].customer_id = "CUST" + std::to_string(i);
+        rows[i].product = "Product" + std::to_string(i % 1000);
+        rows[i].category = CATEGORIES[rng() % 6];
+        rows[i].price = price(rng);
+        rows[i].date = date;
+        rows[i].date_key = dateSortKey(date);
+        rows[i].payment_method = PAYMENTS[rng() % 5];
+    }
+
+    auto elapsed = [](std::chrono::high_resolution_clock::time_point since) {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - since).count();
+    };
+    auto bestOf = [&](std::function<void()> run) {
+        double best = 0.0;
+        for (int r = 0; r < RUNS; r++) {
+            auto start = std::chrono::high_resolution_clock::now();
+            run();
+            double ms = elapsed(start);
+            if (r == 0 || ms < best) best = ms;
         }
-    } else if (sortChoice == 3) {
-        // Selection Sort
-        for (size_t i = 0; i < electronicsTransactions.size(); i++) {
-            size_t min_idx = i;
-            for (size_t j = i + 1; j < electronicsTransactions.size(); j++) {
-                if (electronicsTransactions[j].price < electronicsTransactions[min_idx].price) {
-                    min_idx = j;
-                }
-            }
-            std::swap(electronicsTransactions[i], electronicsTransactions[min_idx]);
+        return best;
+    };
+    auto printRow = [](const char* name, double build, double scan, double traverse, double sort, int matches) {
+        std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << build << std::setw(12) << scan << std::setw(14) << traverse
+                  << std::setw(14) << sort << std::setw(12) << matches << "\n";
+    };
+
+    std::cout << "Storage benchmark, " << n << " transactions (times in ms, scans best of " << RUNS << ")\n";
+    std::cout << std::left << std::setw(16) << "Storage" << std::right << std::setw(12) << "Build"
+              << std::setw(12) << "Filter scan" << std::setw(14) << "Traversal"
+              << std::setw(14) << "Merge sort" << std::setw(12) << "Matches" << "\n";
+    std::cout << std::string(80, '-') << "\n";
+
+    volatile double sink = 0.0;
+    double sortedTraversal = 0.0, compactTime = 0.0, compactedTraversal = 0.0;
+    for (int mode = 0; mode < 2; mode++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        LinkedList list(mode == 1);
+        for (const Transaction& t : rows) list.addTransaction(t);
+        double build = elapsed(start);
+        int categoryCount = 0, paymentCount = 0;
+        double scan = bestOf([&]() {
+            list.countByCategoryAndPayment("Electronics", "Credit Card", categoryCount, paymentCount);
+        });
+        double traverse = bestOf([&]() {
+            double total = 0.0;
+            list.forEachTransaction([&](const Transaction& t) { total += t.price; });
+            sink = sink + total;
+        });
+        list.setAutoCompact(false);
+        auto sortStart = std::chrono::high_resolution_clock::now();
+        list.sortByDate(4);
+        double sort = elapsed(sortStart);
+        printRow(mode == 1 ? "Unrolled list" : "Linked list", build, scan, traverse, sort, paymentCount);
+
+        if (mode == 0) {
+            auto traverseSorted = [&]() {
+                return bestOf([&]() {
+                    double total = 0.0;
+                    list.forEachTransaction([&](const Transaction& t) { total += t.price; });
+                    sink = sink + total;
+                });
+            };
+            sortedTraversal = traverseSorted();
+            auto compactStart = std::chrono::high_resolution_clock::now();
+            list.compact();
+            compactTime = elapsed(compactStart);
+            compactedTraversal = traverseSorted();
         }
-    } else if (sortChoice == 4) {
-        // Quick Sort (using std::sort)
-        std::sort(electronicsTransactions.begin(), electronicsTransactions.end(), 
-            [](const auto& a, const auto& b) { return a.price < b.price; });
-    }
-    
-    auto end = std::chrono::high_resolution_clock::now();
-    duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-    
-    double percentage = (totalElectronics > 0) ? 
-        (static_cast<double>(electronicsCreditCard) / totalElectronics) * 100.0 : 0.0;
-    
-    std::cout << "\nSearch and sort completed in " << duration_ms << " ms\n";
-    std::cout << "Total Electronics purchases: " << totalElectronics << "\n";
-    std::cout << "Electronics purchases with Credit Card: " << electronicsCreditCard << "\n";
-    std::cout << "Percentage: " << percentage << "%\n";
-    
-    // Display some sorted electronics transactions (top 5)
-    std::cout << "\nSorted Electronics Transactions (by price, ascending):\n";
-    int count = 0;
-    for (const auto& t : electronicsTransactions) {
-        if (count++ >= 5) break;
-        std::cout << t.product << " - $" << t.price << " (" << t.payment_method << ")\n";
     }
-}
 
-void LinkedList::findFrequentWordsInOneStarReviews(int sortChoice, long long& duration_ms) {
+    // Contiguous records, the layout Array.cpp uses
     auto start = std::chrono::high_resolution_clock::now();
-    
-    std::vector<std::string> oneStarReviewTexts;
-    
-    // Linear Search to find 1-star reviews (this part stays the same regardless of sort choice)
-    ReviewNode* current = reviewHead;
-    while (current != nullptr) {
-        if (current->data.rating == 1) {
-            oneStarReviewTexts.push_back(current->data.review_text);
+    Transaction* array = new Transaction[n];
+    for (int i = 0; i < n; i++) array[i] = rows[i];
+    double build = elapsed(start);
+    const std::string category = "Electronics", payment = "Credit Card";
+    int paymentCount = 0;
+    double scan = bestOf([&]() {
+        paymentCount = 0;
+        for (int i = 0; i < n; i++) {
+            if (array[i].category == category && array[i].payment_method == payment) paymentCount++;
         }
-        current = current->next;
+    });
+    double traverse = bestOf([&]() {
+        double total = 0.0;
+        for (int i = 0; i < n; i++) total += array[i].price;
+        sink = sink + total;
+    });
+    auto sortStart = std::chrono::high_resolution_clock::now();
+    std::stable_sort(array, array + n, [](const Transaction& a, const Transaction& b) { return a.date_key < b.date_key; });
+    double sort = elapsed(sortStart);
+    printRow("Array", build, scan, traverse, sort, paymentCount);
+    delete[] array;
+
+    std::cout << "\nLinked list traversal after merge sort: " << sortedTraversal << " ms, after compact() "
+              << compactedTraversal << " ms (compact() took " << compactTime << " ms)\n";
+
+    // Date-range counts on the linked list: level-0 walk against the skip list
+    const int RANGE_QUERIES = 100;
+    LinkedList list;
+    for (const Transaction& t : rows) list.addTransaction(t);
+    std::vector<std::pair<int, int>> ranges;
+    for (int q = 0; q < RANGE_QUERIES; q++) {
+        int from = rows[rng() % n].date_key, to = rows[rng() % n].date_key;
+        if (to < from) std::swap(from, to);
+        ranges.push_back(std::make_pair(from, to));
     }
-    
-    // Process the review texts to find frequent words
-    std::map<std::string, int> wordFrequency;
-    for (const auto& text : oneStarReviewTexts) {
-        std::istringstream iss(text);
-        std::string word;
-        while (iss >> word) {
-            // Convert to lowercase and remove punctuation
-            std::transform(word.begin(), word.end(), word.begin(), ::tolower);
-            word.erase(std::remove_if(word.begin(), word.end(), 
-                [](char c) { return std::ispunct(c); }), word.end());
-            
-            if (word.length() > 2) { // Skip very short words
-                wordFrequency[word]++;
-            }
-        }
+    long long linearTotal = 0, indexedTotal = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (const auto& range : ranges) {
+        list.forEachTransaction([&](const Transaction& t) {
+            if (t.date_key >= range.first && t.date_key <= range.second) linearTotal++;
+        });
     }
-    
-    // Convert to vector for sorting
-    std::vector<std::pair<std::string, int>> wordFreqVec(wordFrequency.begin(), wordFrequency.end());
-    
-    // Apply different sorting algorithms based on user choice
-    if (sortChoice == 1) {
-        // Bubble Sort
-        for (size_t i = 0; i < wordFreqVec.size(); i++) {
-            for (size_t j = 0; j < wordFreqVec.size() - i - 1; j++) {
-                if (wordFreqVec[j].second < wordFreqVec[j + 1].second) {
-                    std::swap(wordFreqVec[j], wordFreqVec[j + 1]);
-                }
-            }
-        }
-    } else if (sortChoice == 2) {
-        // Insertion Sort
-        for (size_t i = 1; i < wordFreqVec.size(); i++) {
-            auto key = wordFreqVec[i];
-            int j = i - 1;
-            while (j >= 0 && wordFreqVec[j].second < key.second) {
-                wordFreqVec[j + 1] = wordFreqVec[j];
-                j--;
-            }
-            wordFreqVec[j + 1] = key;
+    double linearMs = elapsed(start);
+    start = std::chrono::high_resolution_clock::now();
+    list.countTransactionsInDateRange(0, 0);   // builds the skip lists
+    double indexBuild = elapsed(start);
+    start = std::chrono::high_resolution_clock::now();
+    for (const auto& range : ranges) indexedTotal += list.countTransactionsInDateRange(range.first, range.second);
+    double indexedMs = elapsed(start);
+    std::cout << RANGE_QUERIES << " date-range counts on the linked list: linear " << linearMs
+              << " ms, skip list " << indexedMs << " ms (+" << indexBuild << " ms to build both indexes)"
+              << (linearTotal == indexedTotal ? "" : "  MISMATCH") << "\n";
+
+    // insertAfter on the unrolled list against a vector of the same IDs: full
+    // blocks split on either side of the half, an insert after the tail and
+    // appends behind it
+    const int half = UNROLLED_BLOCK_SIZE / 2;
+    int checkRows = n < 2048 ? n : 2048;
+    if (checkRows == 0) return;
+    UnrolledTransactionList unrolledList;
+    std::vector<std::string> model;
+    for (int i = 0; i < checkRows; i++) {
+        unrolledList.append(rows[i]);
+        model.push_back(rows[i].customer_id);
+    }
+    int inserted = 0;
+    auto insertAt = [&](int position) {
+        Transaction t = rows[rng() % checkRows];
+        t.customer_id = "INSERT" + std::to_string(inserted++);
+        TransactionBlock* block = unrolledList.firstBlock();
+        int index = position;
+        while (index >= block->count) {
+            index -= block->count;
+            block = block->next;
         }
-    } else if (sortChoice == 3) {
-        // Selection Sort
-        for (size_t i = 0; i < wordFreqVec.size(); i++) {
-            size_t max_idx = i;
-            for (size_t j = i + 1; j < wordFreqVec.size(); j++) {
-                if (wordFreqVec[j].second > wordFreqVec[max_idx].second) {
-                    max_idx = j;
-                }
-            }
-            std::swap(wordFreqVec[i], wordFreqVec[max_idx]);
+        unrolledList.insertAfter(block, index, t);
+        model.insert(model.begin() + position + 1, t.customer_id);
+    };
+    const int offsets[] = {half - 1, half, UNROLLED_BLOCK_SIZE - 1, 0};
+    for (int offset : offsets) {
+        int position = 0;
+        TransactionBlock* block = unrolledList.firstBlock();
+        while (block != nullptr && block->count < UNROLLED_BLOCK_SIZE) {
+            position += block->count;
+            block = block->next;
         }
-    } else if (sortChoice == 4) {
-        // Quick Sort (using std::sort)
-        std::sort(wordFreqVec.begin(), wordFreqVec.end(), 
-            [](const auto& a, const auto& b) { return a.second > b.second; });
+        if (block != nullptr) insertAt(position + offset);
     }
-    
-    auto end = std::chrono::high_resolution_clock::now();
-    duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-    
-    std::cout << "\nAnalysis completed in " << duration_ms << " ms\n";
-    std::cout << "Number of 1-star reviews: " << oneStarReviewTexts.size() << "\n";
-    std::cout << "Most frequent words in 1-star reviews:\n";
-    
-    int count = 0;
-    for (const auto& pair : wordFreqVec) {
-        if (count++ >= 10) break; // Show top 10
-        std::cout << pair.first << ": " << pair.second << " occurrences\n";
+    insertAt(static_cast<int>(model.size()) - 1);
+    for (int i = 0; i < 4 * checkRows; i++) insertAt(static_cast<int>(rng() % model.size()));
+    for (int i = 0; i < 3; i++) {
+        unrolledList.append(rows[i]);
+        model.push_back(rows[i].customer_id);
     }
-}
-
-// Load transactions from CSV
-void loadTransactions(LinkedList& list, const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error opening transactions file: " << filename << "\n";
-        return;
-    }
-    std::string line;
-    std::getline(file, line); // Skip header
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string token;
-        Transaction t;
-        int field = 0;
-        while (std::getline(ss, token, ',')) {
-            if (field == 0) t.customer_id = token;
-            else if (field == 1) t.product = token;
-            else if (field == 2) t.category = token;
-            else if (field == 3) {
-                try {
-                    t.price = std::stod(token);
-                } catch (...) {
-                    t.price = 0.0;
-                }
-            }
-            else if (field == 4) t.date = standardizeDate(token);
-            else if (field == 5) t.payment_method = token;
-            field++;
+    bool same = unrolledList.size() == static_cast<int>(model.size());
+    size_t at = 0;
+    for (TransactionBlock* b = unrolledList.firstBlock(); b != nullptr && same; b = b->next) {
+        for (int i = 0; i < b->count && same; i++) {
+            same = at < model.size() && b->items[i].customer_id == model[at++] &&
+                   b->dateKeys[i] == b->items[i].date_key;
         }
-        list.addTransaction(t);
     }
-    file.close();
+    same = same && at == model.size();
+    std::cout << "Unrolled list insertAfter, " << inserted << " inserts into " << checkRows << " rows: "
+              << (same ? "matches" : "MISMATCH") << "\n";
 }
 
-// Load reviews from CSV
-void loadReviews(LinkedList& list, const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error opening reviews file: " << filename << "\n";
-        return;
+// benchmark.cpp links this file with PR1_NO_MAIN defined
+#ifndef PR1_NO_MAIN
+// Menu over the plain or unrolled list; Q1-Q3 run through DataStore
+template <typename Backend>
+int runMenu() {
+    DataStore<Backend> store;
+    if (!store.loadTransactions("transactions_cleaned.csv")) {
+        std::cerr << "Error opening transactions file: transactions_cleaned.csv\n";
     }
-    std::string line;
-    std::getline(file, line); // Skip header
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string token;
-        Review r;
-        int field = 0;
-        while (std::getline(ss, token, ',')) {
-            if (field == 0) r.product_id = token;
-            else if (field == 1) r.customer_id = token;
-            else if (field == 2) {
-                try {
-                    r.rating = std::stoi(token);
-                } catch (...) {
-                    r.rating = 0;
-                }
-            }
-            else if (field == 3) {
-                r.review_text = token;
-                // Append remaining line (handles commas in review text)
-                std::string remaining;
-                std::getline(ss, remaining);
-                if (!remaining.empty()) r.review_text += "," + remaining;
-            }
-            field++;
-        }
-        list.addReview(r);
+    if (!store.loadReviews("reviews_cleaned.csv")) {
+        std::cerr << "Error opening reviews file: reviews_cleaned.csv\n";
     }
-    file.close();
-}
-
-// Main function for user interaction
-int main() {
-    LinkedList list;
-    loadTransactions(list, "transactions_cleaned.csv");
-    loadReviews(list, "reviews_cleaned.csv");
 
     while (true) {
-        std::cout << "\nE-commerce Transaction Analysis System (Linked List Implementation)\n";
+        std::cout << "\nE-commerce Transaction Analysis System (" << store.name() << " Implementation)\n";
         std::cout << "=================================================================\n";
         std::cout << "Choose a question to analyze:\n";
         std::cout << "1. Sort transactions by date and display counts\n";
@@ -524,50 +691,43 @@ int main() {
             continue;
         }
 
-        long long duration_ms = 0;
-
-        if (question_choice == 1) {
-            std::cout << "\nChoose Sorting Algorithm:\n";
-            std::cout << "1. Bubble Sort\n";
-            std::cout << "2. Insertion Sort\n";
-            std::cout << "3. Selection Sort\n";
-            std::cout << "4. Merge Sort\n";
-            std::cout << "Enter choice (1-4): ";
-            int sort_choice;
-            std::cin >> sort_choice;
-            list.sortTransactionsByDate(sort_choice, duration_ms);
-        } else if (question_choice == 2) {
+        int search_choice = 1;
+        int sort_choice = 4;
+        if (question_choice == 2) {
             std::cout << "\nChoose Search Algorithm:\n";
             std::cout << "1. Linear Search\n";
-            std::cout << "2. Binary Search (Note: Using Linear Search for Linked List)\n";
-            std::cout << "3. Jump Search (Note: Using Linear Search for Linked List)\n";
-            std::cout << "4. Interpolation Search (Note: Using Linear Search for Linked List)\n";
+            std::cout << "2. Binary Search (skip-list descent)\n";
+            std::cout << "3. Jump Search (skip-list express lane)\n";
+            std::cout << "4. Interpolation Search (skip-list rank probes)\n";
             std::cout << "Enter choice (1-4): ";
-            int search_choice;
             std::cin >> search_choice;
-            
-            std::cout << "\nChoose Sorting Algorithm:\n";
-            std::cout << "1. Bubble Sort\n";
-            std::cout << "2. Insertion Sort\n";
-            std::cout << "3. Selection Sort\n";
-            std::cout << "4. Quick Sort\n";
-            std::cout << "Enter choice (1-4): ";
-            int sort_choice;
-            std::cin >> sort_choice;
-            
-            list.calculateElectronicsCreditCardPercentage(search_choice, sort_choice, duration_ms);
-        } else if (question_choice == 3) {
+        } else {
             std::cout << "\nChoose Sorting Algorithm:\n";
             std::cout << "1. Bubble Sort\n";
             std::cout << "2. Insertion Sort\n";
             std::cout << "3. Selection Sort\n";
-            std::cout << "4. Quick Sort\n";
+            std::cout << "4. Merge Sort\n";
             std::cout << "Enter choice (1-4): ";
-            int sort_choice;
             std::cin >> sort_choice;
-            list.findFrequentWordsInOneStarReviews(sort_choice, duration_ms);
         }
+        store.runQuestion(question_choice, search_choice, sort_choice);
     }
 
     return 0;
 }
+
+// Main function for user interaction
+// Usage: ./linked-list [--unrolled] [--bench N]
+int main(int argc, char* argv[]) {
+    bool unrolledStorage = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--unrolled") == 0) {
+            unrolledStorage = true;
+        } else if (std::strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            runStorageBenchmark(std::atoi(argv[++i]));
+            return 0;
+        }
+    }
+    return unrolledStorage ? runMenu<UnrolledListBackend>() : runMenu<LinkedListBackend>();
+}
+#endif // PR1_NO_MAIN
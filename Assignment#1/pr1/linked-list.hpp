@@ -1,32 +1,20 @@
 #ifndef LINKED_LIST_HPP
 #define LINKED_LIST_HPP
 
+#include "records.hpp"
+#include "skip_list.hpp"
 #include <string>
-
-// Struct for transaction data
-struct Transaction {
-    std::string customer_id;
-    std::string product;
-    std::string category;
-    double price;
-    std::string date;
-    std::string payment_method;
-};
-
-// Struct for review data
-struct Review {
-    std::string product_id;
-    std::string customer_id;
-    int rating;
-    std::string review_text;
-};
+#include <new>
+#include <utility>
 
 // Node for transaction linked list
 struct TransactionNode {
     Transaction data;
+    int dateKey;   // data.date_key, next to the link so sorts don't touch the record
     TransactionNode* next;
     
-    TransactionNode(const Transaction& t) : data(t), next(nullptr) {}
+    TransactionNode(const Transaction& t) : data(t), dateKey(t.date_key), next(nullptr) {}
+    TransactionNode(Transaction&& t, int key) : data(std::move(t)), dateKey(key), next(nullptr) {}
 };
 
 // Node for review linked list
@@ -37,39 +25,199 @@ struct ReviewNode {
     ReviewNode(const Review& r) : data(r), next(nullptr) {}
 };
 
-// Helper function declaration
-std::string standardizeDate(const std::string& date);
+// Slab allocator for list nodes. Nodes are constructed in large chunks and are
+// all destroyed together by clear() or the destructor; single nodes are never freed.
+template <typename Node>
+class NodePool {
+private:
+    static const int FIRST_CHUNK_NODES = 256;
+    static const int MAX_CHUNK_NODES = 16384;
+
+    struct Chunk {
+        Node* nodes;
+        int used;
+        int capacity;
+        Chunk* next;
+    };
+    Chunk* chunks;  // newest first
+
+public:
+    NodePool() : chunks(nullptr) {}
+    ~NodePool() { clear(); }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    template <typename... Args>
+    Node* create(Args&&... args) {
+        if (chunks == nullptr || chunks->used == chunks->capacity) {
+            int capacity = chunks == nullptr ? FIRST_CHUNK_NODES : chunks->capacity * 2;
+            if (capacity > MAX_CHUNK_NODES) capacity = MAX_CHUNK_NODES;
+            Chunk* chunk = new Chunk;
+            chunk->nodes = static_cast<Node*>(::operator new(sizeof(Node) * capacity));
+            chunk->used = 0;
+            chunk->capacity = capacity;
+            chunk->next = chunks;
+            chunks = chunk;
+        }
+        Node* node = new (chunks->nodes + chunks->used) Node(std::forward<Args>(args)...);
+        chunks->used++;
+        return node;
+    }
+
+    void clear() {
+        while (chunks != nullptr) {
+            Chunk* next = chunks->next;
+            for (int i = 0; i < chunks->used; i++) chunks->nodes[i].~Node();
+            ::operator delete(chunks->nodes);
+            delete chunks;
+            chunks = next;
+        }
+    }
+
+    void swap(NodePool& other) { std::swap(chunks, other.chunks); }
+};
+
+// Records per unrolled-list block. One hop now reaches 16 transactions instead of 1.
+const int UNROLLED_BLOCK_SIZE = 16;
+
+// Node of the unrolled transaction list: a small array of records plus one link
+struct TransactionBlock {
+    Transaction items[UNROLLED_BLOCK_SIZE];
+    int dateKeys[UNROLLED_BLOCK_SIZE];   // date_key of each item, moved with it
+    int count;
+    TransactionBlock* next;
+
+    TransactionBlock() : count(0), next(nullptr) {}
+};
+
+// Unrolled linked list of transactions. Keeps list semantics (O(1) append and
+// O(1) insert after a known position, splitting a full block in half) while
+// scans touch one block pointer per UNROLLED_BLOCK_SIZE records.
+class UnrolledTransactionList {
+private:
+    TransactionBlock* head;
+    TransactionBlock* tail;
+    int count;
+    NodePool<TransactionBlock> blockPool;
+
+    void bubbleSortByDate();
+    void insertionSortByDate();
+    void selectionSortByDate();
+    void mergeSortByDate();
+
+public:
+    UnrolledTransactionList();
+
+    void append(const Transaction& t);
+    // Inserts t right after items[index] of block
+    void insertAfter(TransactionBlock* block, int index, const Transaction& t);
+    void sortByDate(int sortChoice);
+
+    TransactionBlock* firstBlock() const { return head; }
+    int size() const { return count; }
+};
+
+// Sorts of at least this many transactions are followed by compact()
+const int COMPACT_AFTER_SORT_MIN_NODES = 4096;
 
 // Main LinkedList class
 class LinkedList {
 private:
     TransactionNode* transactionHead;
+    TransactionNode* transactionTail;
     ReviewNode* reviewHead;
+    ReviewNode* reviewTail;
     int transactionCount;
     int reviewCount;
+
+    // Unrolled storage mode: transactions live in unrolledTransactions instead
+    bool unrolled;
+    UnrolledTransactionList unrolledTransactions;
+
+    // Nodes are carved out of these pools and freed all at once in ~LinkedList
+    NodePool<TransactionNode> transactionPool;
+    NodePool<ReviewNode> reviewPool;
+
+    // Skip-list indexes over the transaction nodes by category and by date.
+    // Built on first use, kept up to date by addTransaction and dropped by
+    // sorts, which move records between nodes. Not used in unrolled mode,
+    // where records move whenever a block is split or sorted.
+    SkipListIndex<Transaction> categoryIndex;
+    SkipListIndex<Transaction, int> dateIndex;
+    bool skipIndexesValid;
+
+    void ensureSkipIndexes();
+
+    // Re-finds the last transaction node after a sort that relinks nodes
+    void updateTransactionTail();
+
+    // Whether sortByDate compacts large lists afterwards
+    bool autoCompact;
+
     
     // Helper methods for sorting
     void bubbleSortTransactions();
     void insertionSortTransactions();
     void selectionSortTransactions();
     TransactionNode* mergeSortTransactions(TransactionNode* head);
-    TransactionNode* getMiddle(TransactionNode* head);
-    TransactionNode* sortedMerge(TransactionNode* a, TransactionNode* b);
+    // Detaches the ascending run starting at head and returns the node after it
+    TransactionNode* cutRun(TransactionNode* head);
+    // Merges two non-empty sorted lists; tail receives the last node
+    TransactionNode* sortedMerge(TransactionNode* a, TransactionNode* b, TransactionNode*& tail);
     
 public:
-    LinkedList();
+    explicit LinkedList(bool unrolledStorage = false);
     ~LinkedList();
+
+    bool isUnrolled() const { return unrolled; }
+    int getTransactionCount() const { return transactionCount; }
+    int getReviewCount() const { return reviewCount; }
+    void setAutoCompact(bool enabled) { autoCompact = enabled; }
+
+    // Moves the transaction nodes into a fresh pool in current list order, so
+    // a traversal reads memory front to back again after a sort scattered it.
+    // Needs room for a second copy of the nodes while it runs.
+    void compact();
+
+    // Calls fn(transaction) in list order, whichever storage mode is in use
+    template <typename Fn>
+    void forEachTransaction(Fn fn) const {
+        if (unrolled) {
+            for (TransactionBlock* b = unrolledTransactions.firstBlock(); b != nullptr; b = b->next) {
+                for (int i = 0; i < b->count; i++) fn(b->items[i]);
+            }
+        } else {
+            for (TransactionNode* current = transactionHead; current != nullptr; current = current->next) {
+                fn(current->data);
+            }
+        }
+    }
+    
+    // Calls fn(review) in list order
+    template <typename Fn>
+    void forEachReview(Fn fn) const {
+        for (ReviewNode* current = reviewHead; current != nullptr; current = current->next) {
+            fn(current->data);
+        }
+    }
     
     void addTransaction(const Transaction& t);
     void addReview(const Review& r);
-    void sortTransactionsByDate(int sortChoice, long long& duration_ms);
-    void countTransactionsByDate();
-    void calculateElectronicsCreditCardPercentage(int searchChoice, int sortChoice, long long& duration_ms);
-    void findFrequentWordsInOneStarReviews(int sortChoice, long long& duration_ms);
+    // Stable sort by date (sortChoice 1-4 = bubble, insertion, selection, merge)
+    void sortByDate(int sortChoice);
+    // Transactions of a category and, of those, paid with a payment method.
+    // searchChoice 1 scans the list; 2-4 (binary, jump, interpolation) start
+    // from the category skip list, which unrolled mode lacks. Returns the
+    // search used.
+    int countByCategoryAndPayment(const std::string& category, const std::string& payment,
+                                  int& categoryCount, int& paymentCount, int searchChoice = 1);
+    // Transactions with date keys from..to inclusive, counted from skip-list
+    // ranks in O(log n)
+    int countTransactionsInDateRange(int from, int to);
 };
 
-// Helper functions for loading data
-void loadTransactions(LinkedList& list, const std::string& filename);
-void loadReviews(LinkedList& list, const std::string& filename);
+// Times plain list, unrolled list and contiguous array storage on n generated rows
+void runStorageBenchmark(int n);
 
 #endif // LINKED_LIST_HPP
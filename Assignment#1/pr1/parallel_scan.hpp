@@ -0,0 +1,131 @@
+#ifndef PARALLEL_SCAN_HPP
+#define PARALLEL_SCAN_HPP
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <vector>
+
+// Rows below this count per thread are scanned on the calling thread only;
+// waking the pool costs more than the scan itself on small inputs.
+const int MIN_ROWS_PER_CHUNK = 4096;
+
+// Fixed-size pool of worker threads for the parallel scans. The calling thread
+// also takes chunks, so a pool of size 1 has no workers and runs everything inline.
+class ScanThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mtx;
+    std::condition_variable work_cv;
+    std::condition_variable done_cv;
+    const std::function<void(int)>* current_task;
+    int total_chunks;
+    std::atomic<int> next_chunk;
+    int active_workers;
+    unsigned generation;
+    bool stopping;
+
+    void workerLoop() {
+        unsigned seen_generation = 0;
+        while (true) {
+            const std::function<void(int)>* task;
+            int total;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                work_cv.wait(lock, [&] { return stopping || generation != seen_generation; });
+                if (stopping) return;
+                seen_generation = generation;
+                task = current_task;
+                total = total_chunks;
+                active_workers++;
+            }
+            for (int chunk = next_chunk++; chunk < total; chunk = next_chunk++) (*task)(chunk);
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                active_workers--;
+            }
+            done_cv.notify_all();
+        }
+    }
+
+public:
+    explicit ScanThreadPool(int num_threads)
+        : current_task(nullptr), total_chunks(0), next_chunk(0), active_workers(0),
+          generation(0), stopping(false) {
+        for (int i = 1; i < num_threads; i++) workers.emplace_back(&ScanThreadPool::workerLoop, this);
+    }
+
+    ~ScanThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        work_cv.notify_all();
+        for (std::thread& w : workers) w.join();
+    }
+
+    ScanThreadPool(const ScanThreadPool&) = delete;
+    ScanThreadPool& operator=(const ScanThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(workers.size()) + 1; }
+
+    // Runs task(0) .. task(num_chunks - 1) across the pool and returns once all have finished.
+    void run(int num_chunks, const std::function<void(int)>& task) {
+        if (workers.empty() || num_chunks <= 1) {
+            for (int chunk = 0; chunk < num_chunks; chunk++) task(chunk);
+            return;
+        }
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            // A worker that woke late for the previous run may still hold its task pointer
+            done_cv.wait(lock, [&] { return active_workers == 0; });
+            current_task = &task;
+            total_chunks = num_chunks;
+            next_chunk = 0;
+            generation++;
+        }
+        work_cv.notify_all();
+        for (int chunk = next_chunk++; chunk < num_chunks; chunk = next_chunk++) task(chunk);
+        std::unique_lock<std::mutex> lock(mtx);
+        done_cv.wait(lock, [&] { return active_workers == 0; });
+    }
+};
+
+// Number of chunks to split n rows into: one per thread, fewer for small inputs.
+inline int scanChunkCount(const ScanThreadPool& pool, int n) {
+    int chunks = n / MIN_ROWS_PER_CHUNK;
+    if (chunks > pool.size()) chunks = pool.size();
+    return chunks < 1 ? 1 : chunks;
+}
+
+// Calls body(chunk, begin, end) for each contiguous slice of [0, n).
+template <typename Body>
+void parallelForChunks(ScanThreadPool& pool, int n, int chunks, Body body) {
+    pool.run(chunks, [&](int chunk) {
+        int begin = static_cast<int>(static_cast<long long>(n) * chunk / chunks);
+        int end = static_cast<int>(static_cast<long long>(n) * (chunk + 1) / chunks);
+        body(chunk, begin, end);
+    });
+}
+
+// Returns the smallest i in [0, n) for which pred(i) holds, or -1.
+// Chunks past an already-found match stop early.
+template <typename Pred>
+int parallelFindFirst(ScanThreadPool& pool, int n, Pred pred) {
+    int chunks = scanChunkCount(pool, n);
+    std::atomic<int> best(n);
+    parallelForChunks(pool, n, chunks, [&](int, int begin, int end) {
+        for (int i = begin; i < end && i < best.load(std::memory_order_relaxed); i++) {
+            if (pred(i)) {
+                int current = best.load();
+                while (i < current && !best.compare_exchange_weak(current, i)) {}
+                return;
+            }
+        }
+    });
+    return best.load() == n ? -1 : best.load();
+}
+
+#endif // PARALLEL_SCAN_HPP
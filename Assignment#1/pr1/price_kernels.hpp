@@ -0,0 +1,181 @@
+#ifndef PRICE_KERNELS_HPP
+#define PRICE_KERNELS_HPP
+
+#include <cstdint>
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Price band boundaries: band 0 is below the first edge, band k is
+// [edge k-1, edge k), the last band is at or above the last edge.
+const int PRICE_BAND_EDGES = 4;
+const int PRICE_BANDS = PRICE_BAND_EDGES + 1;
+const double PRICE_BAND_EDGE[PRICE_BAND_EDGES] = {100.0, 500.0, 1000.0, 1500.0};
+
+// Result of one pass over a price column
+struct PriceStats {
+    long long count;
+    double sum;
+    double mean;
+    double min;
+    double max;
+    double variance;   // population variance
+    long long band_counts[PRICE_BANDS];
+};
+
+// Selection bitmaps hold one bit per row: bit (i % 64) of word i / 64.
+inline int selectionWords(int n) { return (n + 63) / 64; }
+
+inline void selectRow(uint64_t* selection, int row) {
+    selection[row / 64] |= uint64_t(1) << (row % 64);
+}
+
+// Sums are taken around a shift (the first price) so the variance does not lose
+// precision to cancellation when prices are large compared to their spread.
+struct PriceAccumulator {
+    long long count;
+    double shifted_sum;
+    double shifted_sum_sq;
+    double min;
+    double max;
+    long long at_or_above[PRICE_BAND_EDGES];
+
+    PriceAccumulator() : count(0), shifted_sum(0.0), shifted_sum_sq(0.0),
+                         min(std::numeric_limits<double>::infinity()),
+                         max(-std::numeric_limits<double>::infinity()) {
+        for (int e = 0; e < PRICE_BAND_EDGES; e++) at_or_above[e] = 0;
+    }
+
+    void add(double price, double shift) {
+        double d = price - shift;
+        count++;
+        shifted_sum += d;
+        shifted_sum_sq += d * d;
+        if (price < min) min = price;
+        if (price > max) max = price;
+        for (int e = 0; e < PRICE_BAND_EDGES; e++) at_or_above[e] += price >= PRICE_BAND_EDGE[e];
+    }
+
+    PriceStats finish(double shift) const {
+        PriceStats s;
+        s.count = count;
+        if (count == 0) {
+            s.sum = s.mean = s.min = s.max = s.variance = 0.0;
+        } else {
+            double mean_shifted = shifted_sum / count;
+            s.sum = shifted_sum + shift * count;
+            s.mean = mean_shifted + shift;
+            s.min = min;
+            s.max = max;
+            s.variance = shifted_sum_sq / count - mean_shifted * mean_shifted;
+            if (s.variance < 0.0) s.variance = 0.0;
+        }
+        s.band_counts[0] = count - at_or_above[0];
+        for (int e = 1; e < PRICE_BAND_EDGES; e++) s.band_counts[e] = at_or_above[e - 1] - at_or_above[e];
+        s.band_counts[PRICE_BANDS - 1] = at_or_above[PRICE_BAND_EDGES - 1];
+        return s;
+    }
+};
+
+inline bool rowSelected(const uint64_t* selection, int row) {
+    return selection == nullptr || ((selection[row / 64] >> (row % 64)) & 1);
+}
+
+// Scalar kernel, also used for the tail rows of the AVX2 kernel
+inline void accumulatePricesScalar(const double* prices, int begin, int end, const uint64_t* selection,
+                                   double shift, PriceAccumulator& acc) {
+    for (int i = begin; i < end; i++) {
+        if (rowSelected(selection, i)) acc.add(prices[i], shift);
+    }
+}
+
+#if defined(__AVX2__)
+// Four rows per step. Unselected lanes are masked to 0 for the sums,
+// +inf/-inf for min/max and never counted in the bands.
+inline void accumulatePricesAvx2(const double* prices, int n, const uint64_t* selection,
+                                 double shift, PriceAccumulator& acc) {
+    const __m256d shift_v = _mm256_set1_pd(shift);
+    const __m256d pos_inf = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    const __m256d neg_inf = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+    const __m256i lane_bits = _mm256_setr_epi64x(1, 2, 4, 8);
+    __m256d sum = _mm256_setzero_pd();
+    __m256d sum_sq = _mm256_setzero_pd();
+    __m256d min_v = pos_inf;
+    __m256d max_v = neg_inf;
+    __m256i count = _mm256_setzero_si256();
+    __m256i above[PRICE_BAND_EDGES];
+    __m256d edge[PRICE_BAND_EDGES];
+    for (int e = 0; e < PRICE_BAND_EDGES; e++) {
+        above[e] = _mm256_setzero_si256();
+        edge[e] = _mm256_set1_pd(PRICE_BAND_EDGE[e]);
+    }
+
+    int vec_end = n - n % 4;
+    for (int i = 0; i < vec_end; i += 4) {
+        __m256d mask;
+        if (selection == nullptr) {
+            mask = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        } else {
+            long long bits = static_cast<long long>((selection[i / 64] >> (i % 64)) & 0xF);
+            if (bits == 0) continue;
+            __m256i b = _mm256_and_si256(_mm256_set1_epi64x(bits), lane_bits);
+            mask = _mm256_castsi256_pd(_mm256_cmpeq_epi64(b, lane_bits));
+        }
+        __m256d p = _mm256_loadu_pd(prices + i);
+        __m256d d = _mm256_and_pd(_mm256_sub_pd(p, shift_v), mask);
+        sum = _mm256_add_pd(sum, d);
+        sum_sq = _mm256_add_pd(sum_sq, _mm256_mul_pd(d, d));
+        min_v = _mm256_min_pd(min_v, _mm256_blendv_pd(pos_inf, p, mask));
+        max_v = _mm256_max_pd(max_v, _mm256_blendv_pd(neg_inf, p, mask));
+        // Compare masks are all-ones (-1) per lane, so subtracting counts them
+        count = _mm256_sub_epi64(count, _mm256_castpd_si256(mask));
+        for (int e = 0; e < PRICE_BAND_EDGES; e++) {
+            __m256d ge = _mm256_and_pd(_mm256_cmp_pd(p, edge[e], _CMP_GE_OQ), mask);
+            above[e] = _mm256_sub_epi64(above[e], _mm256_castpd_si256(ge));
+        }
+    }
+
+    alignas(32) double lanes[4];
+    alignas(32) long long counts[4];
+    _mm256_store_pd(lanes, sum);
+    acc.shifted_sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm256_store_pd(lanes, sum_sq);
+    acc.shifted_sum_sq += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm256_store_pd(lanes, min_v);
+    for (double v : lanes) if (v < acc.min) acc.min = v;
+    _mm256_store_pd(lanes, max_v);
+    for (double v : lanes) if (v > acc.max) acc.max = v;
+    _mm256_store_si256(reinterpret_cast<__m256i*>(counts), count);
+    acc.count += counts[0] + counts[1] + counts[2] + counts[3];
+    for (int e = 0; e < PRICE_BAND_EDGES; e++) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(counts), above[e]);
+        acc.at_or_above[e] += counts[0] + counts[1] + counts[2] + counts[3];
+    }
+
+    accumulatePricesScalar(prices, vec_end, n, selection, shift, acc);
+}
+#endif
+
+// Sum, mean, min, max, variance and band counts of prices[0..n-1] in one pass.
+// Only rows set in selection are included; pass nullptr to include every row.
+inline PriceStats computePriceStats(const double* prices, int n, const uint64_t* selection = nullptr) {
+    double shift = 0.0;
+    for (int i = 0; i < n; i++) {
+        if (rowSelected(selection, i)) {
+            shift = prices[i];
+            break;
+        }
+    }
+    PriceAccumulator acc;
+#if defined(__AVX2__)
+    accumulatePricesAvx2(prices, n, selection, shift, acc);
+#else
+    accumulatePricesScalar(prices, 0, n, selection, shift, acc);
+#endif
+    return acc.finish(shift);
+}
+
+#endif // PRICE_KERNELS_HPP
@@ -0,0 +1,49 @@
+#ifndef RECORDS_HPP
+#define RECORDS_HPP
+
+#include <string>
+#include <cstdio>
+
+// Records shared by every container (Array, LinkedList, DataStore backends)
+
+// Struct to represent a transaction from transactions.csv
+struct Transaction {
+    std::string customer_id;
+    std::string product;
+    std::string category;
+    double price;
+    std::string date; // As written in the CSV ("DD/MM/YYYY" or "YYYY-MM-DD"), for display
+    int date_key;     // dateSortKey(date); every date comparison uses this
+    std::string payment_method;
+};
+
+// Struct to represent a review from reviews.csv
+struct Review {
+    std::string product_id;
+    std::string customer_id;
+    int rating;
+    std::string review_text;
+};
+
+// "DD/MM/YYYY", "YYYY-MM-DD" or "YYYYMMDD" as the integer YYYYMMDD, which
+// orders dates chronologically; 0 if the date is not valid
+inline int dateSortKey(const std::string& date) {
+    int day = 0, month = 0, year = 0;
+    char extra;
+    if (std::sscanf(date.c_str(), "%d/%d/%d%c", &day, &month, &year, &extra) != 3 &&
+        std::sscanf(date.c_str(), "%d-%d-%d%c", &year, &month, &day, &extra) != 3) {
+        if (date.size() != 8) return 0;
+        int key = 0;
+        for (char c : date) {
+            if (c < '0' || c > '9') return 0;
+            key = key * 10 + (c - '0');
+        }
+        year = key / 10000;
+        month = key / 100 % 100;
+        day = key % 100;
+    }
+    if (year < 1 || year > 9999 || month < 1 || month > 12 || day < 1 || day > 31) return 0;
+    return year * 10000 + month * 100 + day;
+}
+
+#endif // RECORDS_HPP
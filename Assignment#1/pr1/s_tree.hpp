@@ -0,0 +1,159 @@
+#ifndef S_TREE_HPP
+#define S_TREE_HPP
+
+#include <string>
+#include <vector>
+#include <climits>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Immutable static B+-tree ("S-tree") over a sorted array of int keys.
+// Every node holds STREE_B keys, exactly one 64-byte cache line, so a lookup
+// touches one line per level instead of one per binary-search step.
+// Leaves hold the keys themselves (padded with INT_MAX); internal node j of a
+// layer has children j*(B+1) .. j*(B+1)+B, and key i is the smallest key under
+// child i+1.
+const int STREE_B = 16;
+
+class STree {
+private:
+    int* nodes;          // all layers, leaves first, 64-byte aligned
+    char* storage;       // raw allocation behind nodes
+    int n;
+    int height;
+    std::vector<int> layer_offset;  // first node of each layer
+
+    // Number of keys in the node that are smaller than x
+    static int rank(const int* node, int x) {
+#if defined(__AVX2__)
+        __m256i xv = _mm256_set1_epi32(x);
+        __m256i lo = _mm256_load_si256(reinterpret_cast<const __m256i*>(node));
+        __m256i hi = _mm256_load_si256(reinterpret_cast<const __m256i*>(node + 8));
+        int mask_lo = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(xv, lo)));
+        int mask_hi = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(xv, hi)));
+        return __builtin_popcount(static_cast<unsigned>(mask_lo | (mask_hi << 8)));
+#elif defined(__SSE2__)
+        __m128i xv = _mm_set1_epi32(x);
+        int mask = 0;
+        for (int i = 0; i < STREE_B / 4; i++) {
+            __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(node + 4 * i));
+            mask |= _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(xv, k))) << (4 * i);
+        }
+        return __builtin_popcount(static_cast<unsigned>(mask));
+#else
+        int count = 0;
+        for (int i = 0; i < STREE_B; i++) count += node[i] < x;
+        return count;
+#endif
+    }
+
+    void release() {
+        delete[] storage;
+        storage = nullptr;
+        nodes = nullptr;
+    }
+
+public:
+    STree() : nodes(nullptr), storage(nullptr), n(0), height(0) {}
+    ~STree() { release(); }
+
+    STree(const STree&) = delete;
+    STree& operator=(const STree&) = delete;
+
+    int size() const { return n; }
+
+    // Builds the tree over keys[0..count-1], which must be sorted ascending.
+    void build(const int* keys, int count) {
+        release();
+        n = count;
+        layer_offset.clear();
+
+        std::vector<int> layer_nodes;
+        int leaves = (count + STREE_B - 1) / STREE_B;
+        if (leaves == 0) leaves = 1;
+        layer_nodes.push_back(leaves);
+        while (layer_nodes.back() > 1) {
+            layer_nodes.push_back((layer_nodes.back() + STREE_B) / (STREE_B + 1));
+        }
+        height = static_cast<int>(layer_nodes.size());
+
+        long long total = 0;
+        for (int count_in_layer : layer_nodes) {
+            layer_offset.push_back(static_cast<int>(total));
+            total += count_in_layer;
+        }
+        storage = new char[total * STREE_B * sizeof(int) + 64];
+        nodes = reinterpret_cast<int*>((reinterpret_cast<uintptr_t>(storage) + 63) & ~uintptr_t(63));
+
+        // Leaves: the keys themselves
+        for (long long i = 0; i < static_cast<long long>(leaves) * STREE_B; i++) {
+            nodes[i] = i < count ? keys[i] : INT_MAX;
+        }
+
+        // Smallest key under each node of the layer below, carried up one layer at a time
+        std::vector<int> subtree_min(leaves);
+        for (int j = 0; j < leaves; j++) subtree_min[j] = nodes[j * STREE_B];
+
+        for (int h = 1; h < height; h++) {
+            int below = layer_nodes[h - 1];
+            int* layer = nodes + static_cast<long long>(layer_offset[h]) * STREE_B;
+            std::vector<int> next_min(layer_nodes[h]);
+            for (int j = 0; j < layer_nodes[h]; j++) {
+                int first_child = j * (STREE_B + 1);
+                for (int i = 0; i < STREE_B; i++) {
+                    int child = first_child + i + 1;
+                    layer[j * STREE_B + i] = child < below ? subtree_min[child] : INT_MAX;
+                }
+                next_min[j] = subtree_min[first_child];
+            }
+            subtree_min.swap(next_min);
+        }
+    }
+
+    // Index of the first key >= x, or size() if every key is smaller.
+    int lowerBound(int x) const {
+        if (nodes == nullptr) return n;
+        int node = 0;
+        for (int h = height - 1; h > 0; h--) {
+            const int* keys = nodes + static_cast<long long>(layer_offset[h] + node) * STREE_B;
+            node = node * (STREE_B + 1) + rank(keys, x);
+        }
+        long long pos = static_cast<long long>(node) * STREE_B + rank(nodes + static_cast<long long>(node) * STREE_B, x);
+        return pos < n ? static_cast<int>(pos) : n;
+    }
+};
+
+// S-tree over a sorted column of strings. Each distinct string is replaced by its
+// rank in a sorted dictionary, which preserves order, and the ranks are indexed.
+class STreeStringIndex {
+private:
+    std::vector<std::string> dictionary;
+    std::vector<int> codes;
+    STree tree;
+
+public:
+    // key_at(i) returns the i-th string of a column sorted ascending.
+    template <typename KeyAt>
+    void build(int count, KeyAt key_at) {
+        dictionary.clear();
+        codes.assign(count, 0);
+        for (int i = 0; i < count; i++) {
+            const std::string& key = key_at(i);
+            if (dictionary.empty() || dictionary.back() != key) dictionary.push_back(key);
+            codes[i] = static_cast<int>(dictionary.size()) - 1;
+        }
+        tree.build(codes.data(), count);
+    }
+
+    // Index of the first row whose string is >= key, or the row count.
+    int lowerBound(const std::string& key) const {
+        int code = static_cast<int>(std::lower_bound(dictionary.begin(), dictionary.end(), key) - dictionary.begin());
+        return tree.lowerBound(code);
+    }
+};
+
+#endif // S_TREE_HPP
@@ -0,0 +1,122 @@
+// Lookup benchmark: binary, jump and interpolation search (same loops as the
+// Array::...ByRating versions) against the S-tree index, on sorted int keys.
+//
+// Build: g++ -std=c++14 -O2 -mavx2 search_benchmark.cpp -o search_benchmark
+// Run:   ./search_benchmark [size ...]        (default: 1000000 10000000 100000000)
+//
+// Linear search is left out; at these sizes a single lookup takes milliseconds.
+
+#include "s_tree.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <algorithm>
+#include <vector>
+
+static const int QUERIES = 1000000;
+static const int JUMP_QUERIES = 10000;  // jump search is O(sqrt n) per lookup
+
+int binarySearch(const int* keys, int n, int key) {
+    int low = 0, high = n - 1;
+    while (low <= high) {
+        int mid = low + (high - low) / 2;
+        if (keys[mid] == key) return mid;
+        else if (keys[mid] < key) low = mid + 1;
+        else high = mid - 1;
+    }
+    return -1;
+}
+
+int jumpSearch(const int* keys, int n, int key) {
+    int step = static_cast<int>(std::sqrt(n));
+    int prev = 0;
+    while (prev < n && keys[prev] < key) prev += step;
+    int start = prev - step < 0 ? 0 : prev - step;
+    for (int i = start; i < n && i <= prev; i++) {
+        if (keys[i] == key) return i;
+    }
+    return -1;
+}
+
+int interpolationSearch(const int* keys, int n, int key) {
+    int low = 0, high = n - 1;
+    while (low <= high && key >= keys[low] && key <= keys[high]) {
+        if (low == high) return keys[low] == key ? low : -1;
+        if (keys[high] == keys[low]) return keys[low] == key ? low : -1;
+        int pos = low + static_cast<int>((static_cast<long long>(key - keys[low]) * (high - low)) / (keys[high] - keys[low]));
+        if (pos < low || pos > high) return -1;
+        if (keys[pos] == key) return pos;
+        else if (keys[pos] < key) low = pos + 1;
+        else high = pos - 1;
+    }
+    return -1;
+}
+
+// Runs every query through search, checks each hit and returns ns per lookup.
+template <typename Search>
+double timeLookups(const std::vector<int>& keys, const std::vector<int>& queries, int count, Search search) {
+    long long found = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int q = 0; q < count; q++) {
+        int idx = search(queries[q]);
+        if (idx >= 0 && keys[idx] == queries[q]) found++;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    if (found != count) std::cerr << "Warning: " << (count - found) << " lookups missed\n";
+    return std::chrono::duration<double, std::nano>(end - start).count() / count;
+}
+
+void runBenchmark(int n) {
+    std::mt19937 rng(42);
+    std::vector<int> keys(n);
+    // Duplicate keys, like the category/date/rating columns
+    std::uniform_int_distribution<int> key_dist(0, n / 2);
+    for (int i = 0; i < n; i++) keys[i] = key_dist(rng);
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<int> queries(QUERIES);
+    std::uniform_int_distribution<int> pick(0, n - 1);
+    for (int q = 0; q < QUERIES; q++) queries[q] = keys[pick(rng)];
+
+    auto build_start = std::chrono::high_resolution_clock::now();
+    STree tree;
+    tree.build(keys.data(), n);
+    auto build_end = std::chrono::high_resolution_clock::now();
+
+    const int* k = keys.data();
+    double binary = timeLookups(keys, queries, QUERIES, [&](int key) { return binarySearch(k, n, key); });
+    double jump = timeLookups(keys, queries, JUMP_QUERIES, [&](int key) { return jumpSearch(k, n, key); });
+    double interpolation = timeLookups(keys, queries, QUERIES, [&](int key) { return interpolationSearch(k, n, key); });
+    double stree = timeLookups(keys, queries, QUERIES, [&](int key) { return tree.lowerBound(key); });
+
+    std::cout << std::left << std::setw(12) << n
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << binary
+              << std::setw(12) << jump
+              << std::setw(15) << interpolation
+              << std::setw(10) << stree
+              << std::setw(14) << std::chrono::duration<double, std::milli>(build_end - build_start).count()
+              << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++) sizes.push_back(std::atoi(argv[i]));
+    if (sizes.empty()) sizes = {1000000, 10000000, 100000000};
+
+    std::cout << "Average lookup time (ns), S-tree build time (ms)\n";
+    std::cout << std::left << std::setw(12) << "Keys"
+              << std::right << std::setw(12) << "Binary"
+              << std::setw(12) << "Jump"
+              << std::setw(15) << "Interpolation"
+              << std::setw(10) << "S-Tree"
+              << std::setw(14) << "Build (ms)" << "\n";
+    std::cout << std::string(75, '-') << "\n";
+    for (int n : sizes) {
+        if (n > 0) runBenchmark(n);
+    }
+    return 0;
+}
@@ -0,0 +1,236 @@
+#ifndef SKIP_LIST_HPP
+#define SKIP_LIST_HPP
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+
+// Tallest tower. With one entry in four promoted per level this covers
+// 4^16 entries, far more than the transaction files hold.
+const int SKIP_LIST_MAX_LEVEL = 16;
+
+// Skip list over records of an existing linked list, ordered by one field
+// of type Key (a string or an int). The records stay where they are; each entry points at one and adds a
+// tower of express links. Every link also stores how many level-0 steps it
+// skips, so an entry can be reached by rank in O(log n) expected time.
+// Entries with equal keys keep the order in which they were inserted.
+template <typename Record, typename Key = std::string>
+class SkipListIndex {
+public:
+    struct Entry;
+
+    struct Link {
+        Entry* next;
+        int width;   // level-0 steps from this entry to next; unused while next is null
+    };
+
+    struct Entry {
+        const Record* record;
+        int height;
+        Link links[1];   // really links[height]
+
+        Entry* next() const { return links[0].next; }
+    };
+
+private:
+    Key Record::* keyField;
+    Entry* head;          // sentinel with a full-height tower, not a record
+    int count;
+    int level;            // levels in use
+    std::mt19937 rng;
+
+    // Entries are bump-allocated from chunks and released all at once
+    std::vector<char*> chunks;
+    size_t chunkUsed;
+    static const size_t CHUNK_BYTES = 1 << 16;
+
+    Entry* allocate(int height) {
+        size_t bytes = sizeof(Entry) + (height - 1) * sizeof(Link);
+        bytes = (bytes + alignof(Entry) - 1) & ~(alignof(Entry) - 1);
+        if (chunks.empty() || chunkUsed + bytes > CHUNK_BYTES) {
+            chunks.push_back(static_cast<char*>(::operator new(CHUNK_BYTES)));
+            chunkUsed = 0;
+        }
+        Entry* entry = reinterpret_cast<Entry*>(chunks.back() + chunkUsed);
+        chunkUsed += bytes;
+        entry->record = nullptr;
+        entry->height = height;
+        for (int l = 0; l < height; l++) entry->links[l] = Link{nullptr, 0};
+        return entry;
+    }
+
+    void release() {
+        for (char* chunk : chunks) ::operator delete(chunk);
+        chunks.clear();
+        chunkUsed = 0;
+    }
+
+    int randomHeight() {
+        int height = 1;
+        uint32_t bits = rng();
+        while (height < SKIP_LIST_MAX_LEVEL && (bits & 3) == 0) {
+            height++;
+            bits >>= 2;
+        }
+        return height;
+    }
+
+    const Key& keyOf(const Entry* entry) const { return entry->record->*keyField; }
+
+    // Orders strings by their first eight bytes, for interpolation
+    static uint64_t keyNumber(const std::string& key) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < 8; i++) {
+            value = (value << 8) | (i < key.size() ? static_cast<unsigned char>(key[i]) : 0);
+        }
+        return value;
+    }
+    // Ints shifted to be non-negative, keeping their order
+    static uint64_t keyNumber(int key) { return static_cast<uint64_t>(static_cast<int64_t>(key) - INT32_MIN); }
+
+public:
+    explicit SkipListIndex(Key Record::* field)
+        : keyField(field), head(nullptr), count(0), level(1), rng(12345), chunkUsed(0) {
+        clear();
+    }
+    ~SkipListIndex() { release(); }
+
+    SkipListIndex(const SkipListIndex&) = delete;
+    SkipListIndex& operator=(const SkipListIndex&) = delete;
+
+    void clear() {
+        release();
+        head = allocate(SKIP_LIST_MAX_LEVEL);
+        count = 0;
+        level = 1;
+    }
+
+    int size() const { return count; }
+    Entry* first() const { return head->links[0].next; }
+
+    // Adds record after every entry with the same key. O(log n) expected.
+    void insert(const Record* record) {
+        const Key& key = record->*keyField;
+        Entry* update[SKIP_LIST_MAX_LEVEL];
+        int rankAt[SKIP_LIST_MAX_LEVEL];   // rank of update[l], head = 0
+        Entry* x = head;
+        int rank = 0;
+        for (int l = level - 1; l >= 0; l--) {
+            while (x->links[l].next != nullptr && !(key < keyOf(x->links[l].next))) {
+                rank += x->links[l].width;
+                x = x->links[l].next;
+            }
+            update[l] = x;
+            rankAt[l] = rank;
+        }
+
+        int height = randomHeight();
+        if (height > level) {
+            for (int l = level; l < height; l++) {
+                update[l] = head;
+                rankAt[l] = 0;
+            }
+            level = height;
+        }
+
+        Entry* entry = allocate(height);
+        entry->record = record;
+        int newRank = rank + 1;   // entry rank, first entry = 1
+        for (int l = 0; l < height; l++) {
+            Link& prev = update[l]->links[l];
+            entry->links[l].next = prev.next;
+            entry->links[l].width = prev.width - (newRank - rankAt[l]) + 1;
+            prev.next = entry;
+            prev.width = newRank - rankAt[l];
+        }
+        for (int l = height; l < level; l++) update[l]->links[l].width++;
+        count++;
+    }
+
+    // First entry whose key is >= key, by descending the towers (the skip-list
+    // form of binary search). Returns null if every key is smaller.
+    Entry* lowerBound(const Key& key) const {
+        Entry* x = head;
+        for (int l = level - 1; l >= 0; l--) {
+            while (x->links[l].next != nullptr && keyOf(x->links[l].next) < key) x = x->links[l].next;
+        }
+        return x->links[0].next;
+    }
+
+    // Number of entries whose key is < key, or <= key when orEqual, summed from
+    // the widths of the links passed over on the way down
+    int countBelow(const Key& key, bool orEqual = false) const {
+        Entry* x = head;
+        int rank = 0;
+        for (int l = level - 1; l >= 0; l--) {
+            while (x->links[l].next != nullptr) {
+                const Key& next = keyOf(x->links[l].next);
+                if (orEqual ? key < next : !(next < key)) break;
+                rank += x->links[l].width;
+                x = x->links[l].next;
+            }
+        }
+        return rank;
+    }
+
+    // Same result as lowerBound, found like jump search: step along the one
+    // express lane whose links skip about sqrt(n) entries, then walk level 0.
+    Entry* jumpSearch(const Key& key) const {
+        int lane = 0;
+        for (long long stride = 4; lane + 1 < level && stride * stride <= count; stride *= 4) lane++;
+        Entry* x = head;
+        while (x->links[lane].next != nullptr && keyOf(x->links[lane].next) < key) x = x->links[lane].next;
+        Entry* y = x->links[0].next;
+        while (y != nullptr && keyOf(y) < key) y = y->next();
+        return y;
+    }
+
+    // Entry at 0-based rank, or null. O(log n) expected.
+    Entry* at(int rank) const {
+        if (rank < 0 || rank >= count) return nullptr;
+        int target = rank + 1;
+        int pos = 0;
+        Entry* x = head;
+        for (int l = level - 1; l >= 0; l--) {
+            while (x->links[l].next != nullptr && pos + x->links[l].width <= target) {
+                pos += x->links[l].width;
+                x = x->links[l].next;
+            }
+        }
+        return x;
+    }
+
+    // Same result as lowerBound, found like interpolation search: probes are
+    // ranks estimated from the keys at both ends of the range and reached with
+    // at(). Every other probe is the midpoint so skewed keys stay O(log n) probes.
+    Entry* interpolationSearch(const Key& key) const {
+        int low = 0, high = count;   // answer rank is in [low, high]
+        uint64_t target = keyNumber(key);
+        bool bisect = false;
+        while (low < high) {
+            Entry* lowEntry = at(low);
+            if (!(keyOf(lowEntry) < key)) return lowEntry;
+            Entry* highEntry = at(high - 1);
+            if (keyOf(highEntry) < key) return highEntry->next();
+            uint64_t lowKey = keyNumber(keyOf(lowEntry));
+            uint64_t highKey = keyNumber(keyOf(highEntry));
+            int pos;
+            if (bisect || highKey <= lowKey || target < lowKey) {
+                pos = low + (high - 1 - low) / 2;
+            } else {
+                double fraction = static_cast<double>(target - lowKey) / static_cast<double>(highKey - lowKey);
+                pos = low + static_cast<int>(fraction * (high - 1 - low));
+                if (pos > high - 1) pos = high - 1;
+            }
+            bisect = !bisect;
+            if (keyOf(at(pos)) < key) low = pos + 1;
+            else high = pos;
+        }
+        return at(low);
+    }
+};
+
+#endif // SKIP_LIST_HPP
@@ -0,0 +1,109 @@
+#pragma once
+#include "viewer.hpp"
+#include <string>
+#include <cstdio>
+#include <cstddef>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// How far an admission record must get before dequeueViewer returns
+enum class LogDurability {
+    None,       // Queued for the writer thread; flushed to the OS per batch, never fsynced
+    Batched,    // Queued; the writer flushes and fsyncs once per batch (group commit)
+    PerRecord   // Written, flushed and fsynced by the caller before returning
+};
+
+const char* durabilityName(LogDurability durability);
+
+// Group-commit writer behind AdmissionLog and QueueJournal. In the queued
+// modes the appending thread copies text into a single-producer/single-
+// consumer ring buffer and returns; a background writer drains the ring and
+// writes everything it finds as one batch, once BATCH_BYTES are pending or
+// FLUSH_INTERVAL_MS have passed. In PerRecord mode write() writes, flushes
+// and fsyncs on the caller's thread. Only one thread may call write() at a
+// time.
+class LogWriter {
+public:
+    static const size_t RING_BYTES = 1 << 20;    // Must be a power of two
+    static const size_t BATCH_BYTES = 64 * 1024;
+    static const int FLUSH_INTERVAL_MS = 5;
+
+    LogWriter();
+    ~LogWriter();
+
+    LogWriter(const LogWriter&) = delete;
+    LogWriter& operator=(const LogWriter&) = delete;
+
+    // Starts writing to file, which the caller keeps open until stop()
+    void start(std::FILE* file, LogDurability durability);
+    // Writes out and commits everything queued, then lets go of the file
+    void stop();
+
+    void write(const char* text, size_t length);
+    // Blocks until everything written so far has been written and committed
+    void flush();
+
+private:
+    std::FILE* file;
+    LogDurability durability;
+
+    // Ring buffer of log text. head is advanced only by write(), tail only by
+    // the writer; both count bytes ever written, so head - tail is the fill.
+    char* ring;
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+    alignas(64) std::atomic<size_t> committed;  // Bytes written and committed to the file
+    size_t notifiedAt;                          // head when the writer was last woken
+
+    std::thread writer;
+    std::atomic<bool> stopping;
+    std::atomic<bool> flushRequested;
+    std::mutex wakeMutex;
+    std::condition_variable wake;       // Wakes the writer early when a batch is full
+    std::condition_variable drained;    // Signals flush() after each commit
+
+    void push(const char* text, size_t length);
+    void writerLoop();
+    void writeRange(size_t from, size_t to);
+    void commit();
+};
+
+// Append-only CSV log of admitted viewers (admitted_viewers.csv), written
+// through a LogWriter. Only one thread may call append() at a time.
+class AdmissionLog {
+public:
+    AdmissionLog();
+    ~AdmissionLog();
+
+    // Opens filename for appending and writes the CSV header if the file is
+    // new. Returns false if the file cannot be opened.
+    bool open(const std::string& filename, LogDurability durability);
+    // Drains every queued record to the file and closes it
+    void close();
+
+    // Adds one admission record
+    void append(const std::string& viewerID, const std::string& viewerName, int priority,
+                const std::string& admitTime, const std::string& channelID);
+    // Adds one record per viewer, viewer i on channel *channelIDs[i], as a
+    // single write; in PerRecord mode the whole batch shares one fsync
+    void appendBatch(Viewer* const* viewers, const std::string* const* channelIDs, int count,
+                     const std::string& admitTime);
+
+    // Blocks until every record appended so far has been written and committed
+    void flush();
+
+    LogDurability getDurability() const { return durability; }
+    bool isOpen() const { return file != nullptr; }
+
+private:
+    std::FILE* file;
+    LogDurability durability;
+    LogWriter writer;
+
+    std::string lines;  // Lines being appended, reused between calls
+
+    static void formatLine(std::string& out, const std::string& viewerID, const std::string& viewerName,
+                           int priority, const std::string& admitTime, const std::string& channelID);
+};
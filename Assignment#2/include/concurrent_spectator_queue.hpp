@@ -0,0 +1,67 @@
+#pragma once
+#include "spectator_queue.hpp"
+#include <atomic>
+
+// Spectator queue for several entry gates enqueueing at once while one
+// admission thread dequeues.
+//
+// Each gate owns a single-producer/single-consumer ring, so gates never
+// contend with each other: enqueueViewer is a store into the gate's own ring
+// and one release store of its tail. The admission thread merges every ring
+// into a SpectatorQueue before each dequeue.
+//
+// Ordering: a dequeue returns the best viewer among all whose enqueueViewer
+// returned before the dequeue started, exactly as SpectatorQueue would.
+// Viewers enqueued while a dequeue runs may be missed by that dequeue only.
+// Ties within a tier go by merge order, which keeps each gate's order and
+// interleaves gates as the admission thread finds them; arrivalOrder is
+// assigned at merge, and viewers the duplicate guard turns away are freed
+// there.
+class ConcurrentSpectatorQueue {
+public:
+    static const int MAX_GATES = 64;
+    static const unsigned GATE_RING_SIZE = 4096;   // Viewers per gate ring, power of two
+
+    explicit ConcurrentSpectatorQueue(const std::string& logFile = "data/admitted_viewers.csv",
+                                      LogDurability durability = LogDurability::Batched,
+                                      QueueMode mode = QueueMode::Heap,
+                                      DuplicateGuard guard = DuplicateGuard::Exact);
+    ~ConcurrentSpectatorQueue();
+
+    ConcurrentSpectatorQueue(const ConcurrentSpectatorQueue&) = delete;
+    ConcurrentSpectatorQueue& operator=(const ConcurrentSpectatorQueue&) = delete;
+
+    // Claims a gate for one producer thread; returns -1 once all are taken
+    int openGate();
+
+    // Producer side, lock-free. Only the thread that opened gate may use it.
+    // Waits (yielding) while the gate's ring is full.
+    void enqueueViewer(int gate, Viewer* v);
+
+    // Admission side; only one thread may call these
+    Viewer* dequeueViewer();
+    int admitBatch(int n, Viewer** out);
+    // Viewers merged or waiting in gate rings
+    int size();
+    bool isEmpty() { return size() == 0; }
+    // The merged queue, for findViewer/changePriority/removeViewer from the
+    // admission thread. Call mergeGates() first to see the latest arrivals.
+    SpectatorQueue& merged() { return queue; }
+    // Moves everything waiting in the gate rings into the merged queue;
+    // returns how many viewers were moved
+    int mergeGates();
+
+private:
+    struct Gate {
+        std::atomic<Viewer**> ring;               // Published by openGate once allocated
+        alignas(64) std::atomic<unsigned> head;   // Advanced by the admission thread
+        alignas(64) std::atomic<unsigned> tail;   // Advanced by the gate's producer
+    };
+
+    Gate gates[MAX_GATES];
+    std::atomic<int> gateCount;     // Gates claimed so far (may exceed MAX_GATES)
+    SpectatorQueue queue;
+    int mergeCounter;   // Next arrivalOrder handed out at merge
+
+    int openGates() const;
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+// Exact set of viewer IDs, stored compactly: the ID bytes sit back to back
+// in one arena, and an open-addressing table holds a 32-bit hash and arena
+// offset per ID. Each ID costs its length plus one byte, and 16 to 32
+// bytes of table depending on how full the table is. IDs must not contain
+// '\0', and the arena is limited to 4 GB.
+//
+// With bloomPrefilter, a Bloom filter (one byte per table slot, 4 probes)
+// answers most lookups of IDs not in the set without touching the table
+// or the arena, with at most about 1 in 400 false positives.
+class IdSet {
+public:
+    explicit IdSet(bool bloomPrefilter = false);
+    ~IdSet();
+
+    IdSet(const IdSet&) = delete;
+    IdSet& operator=(const IdSet&) = delete;
+
+    bool contains(const std::string& id) const;
+    // Adds id; returns false if it was already in the set
+    bool insert(const std::string& id);
+    void clear();
+
+    int size() const { return count; }
+    bool hasPrefilter() const { return bloom != nullptr; }
+    // Heap memory held by the set
+    size_t memoryBytes() const;
+
+private:
+    struct Slot {
+        unsigned hash;
+        unsigned offset;    // Start of the ID in the arena; 0 if the slot is empty
+    };
+
+    Slot* table;
+    int capacity;   // Power of two, kept at least twice count
+    int count;
+
+    // IDs, each followed by '\0'; offset 0 is a placeholder so 0 can mean empty
+    char* arena;
+    size_t arenaSize;
+    size_t arenaCapacity;
+
+    unsigned char* bloom;   // capacity bytes, i.e. 8 bits per table slot; nullptr if off
+
+    static unsigned hashID(const char* data, size_t length);
+    // Table slot holding id, or the empty slot where it would go
+    int find(const std::string& id, unsigned hash) const;
+    bool matches(const Slot& slot, const std::string& id, unsigned hash) const;
+    void grow();
+    void bloomAdd(unsigned hash);
+    bool bloomMayContain(unsigned hash) const;
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include "admission_log.hpp"
+#include <string>
+#include <cstdio>
+
+// Crash-safe record of the viewers waiting in a SpectatorQueue:
+// <base>.snapshot holds every waiting viewer at one point, <base>.oplog every
+// change made since, one line each. Both files carry a generation number and
+// a log is only replayed onto the snapshot of its own generation, so a crash
+// between installing a snapshot and restarting the log never applies a
+// change twice.
+//
+// Both files also carry admitStart, the size the admission log had when the
+// line began, so the line's own admissions can be told from earlier ones.
+//
+// Snapshot: "SNAPSHOT,<generation>,<rows>,<arrivalCounter>,<admitStart>" then
+// one "ViewerID,ViewerName,Priority,ArrivalOrder" row per viewer in admission
+// order. Log: "OPLOG,<generation>,<admitStart>" then the records
+// SpectatorQueue appends.
+class QueueJournal {
+public:
+    QueueJournal();
+    ~QueueJournal();
+
+    QueueJournal(const QueueJournal&) = delete;
+    QueueJournal& operator=(const QueueJournal&) = delete;
+
+    // Reads what base holds. rows gets the snapshot rows (rowCount of them)
+    // and log the whole records of the matching log; a torn last record is
+    // dropped. Returns false if there is no snapshot and no log record.
+    bool read(const std::string& base, std::string& rows, int& rowCount, int& arrivalCounter,
+              long long& admitStart, std::string& log);
+    // Starts appending to base's log after read(); admitStart is the one
+    // read() returned, or for a new line the admission log's current size.
+    // Returns false if the log cannot be written.
+    bool open(const std::string& base, LogDurability durability, long long admitStart);
+    // Appends whole records (each ending in '\n'). PerRecord writes and
+    // fsyncs them before returning; None and Batched queue them for a
+    // LogWriter that commits them in batches, as the admission log does.
+    void append(const std::string& records);
+    // Blocks until every record appended so far is committed
+    void flush();
+    // Installs rows as the next generation's snapshot, then starts its empty log
+    void writeSnapshot(const std::string& rows, int rowCount, int arrivalCounter);
+    // Syncs and closes the log
+    void close();
+    // Closes the log and deletes both files
+    void discard();
+
+    bool isOpen() const { return log != nullptr; }
+    // Records appended since the last snapshot
+    long long recordsSinceSnapshot() const { return records; }
+
+private:
+    std::string base;
+    std::FILE* log;
+    LogWriter writer;
+    LogDurability durability;
+    int generation;
+    long long admitStart;
+    long long records;
+    std::string validLog;       // Log as read, without a torn tail; rewritten by open() if needed
+    bool logIntact;             // The log file on disk is exactly header + validLog
+
+    std::string snapshotPath() const { return base + ".snapshot"; }
+    std::string logPath() const { return base + ".oplog"; }
+    // Starts base's log afresh for the current generation, with text as its
+    // records, and starts the writer on it
+    bool startLog(const std::string& text);
+};
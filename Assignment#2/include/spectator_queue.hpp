@@ -1,39 +1,203 @@
 #pragma once
 #include "viewer.hpp"
+#include "admission_log.hpp"
+#include "queue_journal.hpp"
+#include "wait_histogram.hpp"
+#include "id_set.hpp"
 #include <string>
-#include <cstdio>
+#include <iosfwd>
 
-// Simple linked-list node for stream slots
+// Viewers a stream slot takes when stream_slots.csv has no Capacity column
+const int DEFAULT_SLOT_CAPACITY = 100;
+
+// One row of stream_slots.csv. Times are "YYYY-MM-DDTHH:MM" local time.
 struct StreamSlot {
     std::string slotID;
     std::string timeStart;
     std::string timeEnd;
     std::string channelID;
-    StreamSlot* next;
+    long long startMinute;  // timeStart as minutes since 1970-01-01
+    long long endMinute;    // timeEnd, exclusive
+    int capacity;
+    int assigned;           // Viewers admitted into this slot so far. Not
+                            // journalled, so after a restart every slot
+                            // counts from 0 again.
+};
+
+// Current time in minutes since 1970-01-01, local wall clock
+typedef long long (*AdmitClock)();
+long long wallClockMinute();
+// "YYYY-MM-DDTHH:MM" <-> minutes since 1970-01-01; parseSlotTime returns
+// false if text is not such a time
+bool parseSlotTime(const std::string& text, long long& minute);
+std::string formatSlotTime(long long minute);
+
+// Viewer::priority tiers: 1 VIP, 2 Influencer, 3 Usual
+const int PRIORITY_TIERS = 3;
+
+// How SpectatorQueue orders waiting viewers
+enum class QueueMode {
+    Heap,     // Indexed binary heap on (priority, arrivalOrder), O(log n) per operation
+    Buckets   // One FIFO ring per tier and a bitmap of non-empty tiers, O(1) per
+              // operation. Within a tier viewers leave in enqueue order, which is
+              // arrivalOrder order when arrivalOrder only grows (as loadViewers assigns it).
+              // Priorities outside 1..PRIORITY_TIERS go to the nearest tier.
+};
+
+// Whether SpectatorQueue keeps each viewer ID to one place in line and one
+// admission
+enum class DuplicateGuard {
+    Off,            // Any viewer may be enqueued and admitted
+    Exact,          // An ID already waiting or already admitted in this line is
+                    // turned away. Admitted IDs are kept in an IdSet; when
+                    // openJournal restores a line they are rebuilt from the
+                    // line's part of the admission log, and discardJournal
+                    // forgets them.
+    Prefiltered     // As Exact, with a Bloom filter in front of the admitted IDs
+};
+
+// Identifies a queued viewer until it is dequeued or removed; handles of
+// viewers that have left may be reused
+typedef int ViewerHandle;
+const ViewerHandle NO_HANDLE = -1;
+
+// Heap element: the viewer's ordering key stored inline, so sifting compares
+// contiguous memory instead of following Viewer pointers
+struct HeapEntry {
+    long long key;          // priority, then arrivalOrder; lower leaves first
+    ViewerHandle handle;
+};
+
+// Bucket-mode ring element. A ring entry is live only while its ticket
+// matches the handle's; changePriority and removeViewer leave the old entry
+// behind as a tombstone that dequeue skips.
+struct TierEntry {
+    ViewerHandle handle;
+    unsigned ticket;
+};
+
+// Growable circular FIFO of viewers for one priority tier
+struct ViewerRing {
+    TierEntry* items;
+    int capacity;   // Power of two
+    int head;       // Index of the oldest entry
+    int count;      // Entries including tombstones
+    int live;       // Entries that are not tombstones
+};
+
+// What a handle refers to
+struct HandleSlot {
+    Viewer* viewer;     // nullptr while the slot is free
+    int position;       // Heap mode: index in the heap array
+    unsigned ticket;    // Bucket mode: ticket of the live ring entry
+    int nextFree;       // Next free slot while this one is free
+    long long enqueuedAt;   // Steady-clock nanoseconds when the viewer joined the line
+};
+
+// Slot of the viewer-ID index; the hash is kept so probing and rehashing
+// rarely touch the ID strings
+struct IdIndexEntry {
+    ViewerHandle handle;    // NO_HANDLE if the slot is empty
+    unsigned hash;
+};
+
+// Viewers loaded from one CSV file, allocated as a single array
+struct ViewerBlock {
+    Viewer* viewers;
+    int count;
+    ViewerBlock* next;
 };
 
 class SpectatorQueue {
 public:
-    SpectatorQueue();
+    // Admissions are appended to logFile (an empty name disables the log);
+    // see AdmissionLog for the durability levels
+    explicit SpectatorQueue(const std::string& logFile = "data/admitted_viewers.csv",
+                            LogDurability durability = LogDurability::Batched,
+                            QueueMode mode = QueueMode::Heap,
+                            DuplicateGuard guard = DuplicateGuard::Exact);
     ~SpectatorQueue();
 
-    // Load viewers from CSV (viewers.csv in data/)
-    void loadViewers(const std::string& filename);
-    // Load slots from CSV (stream_slots.csv in data/)
+    // Load viewers from CSV (viewers.csv in data/). All rows go into one
+    // contiguous block of Viewers and the heap is rebuilt bottom-up in O(n)
+    // instead of sifting each row in. Rows the duplicate guard turns away
+    // are skipped; returns how many. With a journal open, the loaded queue
+    // is snapshotted.
+    int loadViewers(const std::string& filename);
+    // Load slots from CSV (stream_slots.csv in data/). An optional fifth
+    // Capacity column sets how many viewers each slot takes.
     void loadSlots(const std::string& filename);
+    // Where admissions are stamped from; wallClockMinute by default
+    void setAdmitClock(AdmitClock clock) { admitClock = clock; }
 
-    // Enqueue a single viewer at runtime
-    void enqueueViewer(Viewer* v);
+    // Enqueue a single viewer at runtime; the queue owns it until it leaves.
+    // v must come from new. Returns NO_HANDLE, and v stays the caller's, if
+    // the duplicate guard turns it away: its ID is waiting or was admitted.
+    ViewerHandle enqueueViewer(Viewer* v);
     // Dequeue the highest-priority viewer (or nullptr if empty)
     Viewer* dequeueViewer();
+    // Dequeue up to n viewers into out (highest priority first) with one log
+    // write; returns how many were admitted
+    int admitBatch(int n, Viewer** out);
+
+    // Handle of the queued viewer with this ID, or NO_HANDLE. Viewer IDs are
+    // expected to be unique; with duplicates the latest one is found.
+    ViewerHandle findViewer(const std::string& id) const;
+    // Move a queued viewer to another tier in O(log n). In heap mode it keeps
+    // its arrivalOrder within the new tier; in bucket mode it joins the back.
+    bool changePriority(ViewerHandle h, int newPriority);
+    // Take a viewer out of the line without admitting it; the caller then
+    // owns it. Returns nullptr for an invalid handle.
+    Viewer* removeViewer(ViewerHandle h);
+
+    // Frees a viewer that has left the queue (dequeued, admitted or removed).
+    // Use this instead of delete: loaded viewers live in a block owned by the
+    // queue, whose memory is returned when the queue is destroyed.
+    void releaseViewer(Viewer* v);
 
     bool isEmpty() const;
     int size() const;
     // Clear all remaining viewers and free memory
     void clearAll();
+    // Wait until every admission so far is committed to the log
+    void flushAdmissionLog();
+
+    QueueMode getMode() const { return mode; }
+
+    // How long admitted viewers of tier t (0 VIP, 1 Influencer, 2 Usual)
+    // waited, from enqueue to admission on the steady clock. Viewers who
+    // leave the line without being admitted are not counted; viewers
+    // restored from a journal count from the restore.
+    const WaitHistogram& waitTimes(int tier) const { return waits[tier]; }
+    // Whether a viewer with this ID has been admitted in this line (always
+    // false with the guard off)
+    bool wasAdmitted(const std::string& id) const { return admittedIDs.contains(id); }
+
+    // Admitted count, p50/p90/p99 and max wait per tier as a table
+    void printWaitTimes(std::ostream& out) const;
+    // The same as CSV with a header row, one row per tier, in nanoseconds
+    void dumpWaitTimes(std::ostream& out) const;
+
+    // Keep the line in a journal (journalBase.snapshot and .oplog, see
+    // QueueJournal) so it survives a restart. Call on an empty queue, before
+    // loading viewers: whatever the journal holds is restored first, and
+    // true is returned if it held a queue, in which case viewers.csv must not
+    // be loaded again. Every later change is logged at the given durability.
+    // The journal also marks where the line's admissions start in the
+    // admission log, which the duplicate guard reads back on a restore.
+    bool openJournal(const std::string& journalBase, LogDurability durability = LogDurability::Batched);
+    // Write a snapshot of the line now and start an empty operation log
+    void snapshotJournal();
+    // Wait until every change so far is committed to the journal
+    void flushJournal();
+    // Stop journaling and delete the journal files; the line is over, so the
+    // duplicate guard forgets its admissions
+    void discardJournal();
 
 private:
-    Viewer** heap;      // Binary heap array of Viewer* pointers
+    QueueMode mode;
+
+    HeapEntry* heap;    // Binary heap array, positions mirrored in HandleSlot::position
     int heapSize;
     int heapCapacity;
     int arrivalCounter; // Next arrivalOrder value when loading
@@ -44,14 +208,118 @@ private:
     void siftUp(int idx);
     // Restore heap downward from idx
     void siftDown(int idx);
-    // Compare two viewers: return positive if a> b (higher priority), negative if a < b
-    int compare(Viewer* a, Viewer* b) const;
+    // Rebuild the heap property over the whole array, bottom-up in O(n)
+    void heapify();
+    // Put entry at idx and record the position in its handle
+    void place(int idx, const HeapEntry& entry);
+    // Ordering key of a viewer: lower is admitted first
+    static long long keyOf(const Viewer* v);
+    // Remove the heap entry at idx and return its handle
+    ViewerHandle removeHeapAt(int idx);
+
+    // Bucket mode: one ring per tier, bit t of tierMask set while tier t has live entries
+    ViewerRing tiers[PRIORITY_TIERS];
+    unsigned tierMask;
+    int bucketCount;
+    unsigned nextTicket;
+
+    static int tierOf(const Viewer* v);
+    void pushTier(int tier, ViewerHandle h);
+    // Remove and return the oldest live handle of the best non-empty tier;
+    // the buckets must not be empty
+    ViewerHandle popBucket();
+    // Account for a live entry of tier turning into a tombstone
+    void dropFromTier(int tier);
+
+    // Handle table with a free list
+    HandleSlot* handles;
+    int handleCapacity;
+    int freeHandle;
+
+    ViewerHandle allocateHandle(Viewer* v);
+    // Free the handle and return its viewer
+    Viewer* releaseHandle(ViewerHandle h);
+    bool isQueued(ViewerHandle h) const;
+
+    // Viewer ID -> handle, open addressing with linear probing
+    IdIndexEntry* idTable;
+    int idCapacity;     // Power of two, kept at least twice idCount
+    int idCount;
+
+    static unsigned hashID(const std::string& id);
+    void indexInsert(ViewerHandle h);
+    void indexErase(ViewerHandle h);
+    void growIndex();
+
+    // Blocks of viewers from loadViewers
+    ViewerBlock* viewerBlocks;
+
+    bool inViewerBlock(const Viewer* v) const;
+    // Make room for extra more viewers without regrowing mid-load
+    void reserve(int extra);
+    // Enqueue count viewers at once; in heap mode the heap is rebuilt once at
+    // the end. Returns how many the duplicate guard turned away.
+    int enqueueBulk(Viewer* viewers, int count);
+
+    // Stream slots sorted by start time. endPrefixMax[i] is the latest end
+    // among slots 0..i, so the slots still running at a time start at a
+    // binary-searchable index. nextOpen chains past full slots
+    // (union-find with path halving).
+    StreamSlot* slots;
+    long long* endPrefixMax;
+    int* nextOpen;
+    int slotCount;
+    AdmitClock admitClock;
+
+    // The first slot in start order running at minute (start <= minute < end)
+    // that still has room. If every running slot is full, the first later slot
+    // with room; if none is running, or nothing has room, nullptr. Counts the
+    // viewer into the slot it returns.
+    StreamSlot* assignSlot(long long minute);
+    int findOpenSlot(int i);
+
+    // Admission log (admitted_viewers.csv), written by a background thread
+    AdmissionLog admitLog;
+
+    // Wait from enqueue to admission, per tier
+    WaitHistogram waits[PRIORITY_TIERS];
+
+    // Free the handle of a viewer being admitted at steady-clock time now,
+    // recording its wait and ID; returns the viewer
+    Viewer* admitHandle(ViewerHandle h, long long now);
+
+    // Admission log file name, "" if there is none
+    std::string admitLogFile;
+
+    // With the guard on, every waiting ID is unique and none is in
+    // admittedIDs, so no admission can repeat an earlier one in the line
+    DuplicateGuard guard;
+    IdSet admittedIDs;
+
+    // Whether the guard turns v away
+    bool isDuplicate(const Viewer* v) const;
+    // Add the IDs of the admissions in the admission log from byte from on
+    // to admittedIDs
+    void loadAdmittedIDs(long long from);
 
-    // Linked list of stream slots
-    StreamSlot* slotsHead;
+    // The log is compacted into a snapshot once it holds this many records
+    // and more records than there are viewers waiting
+    static const long long JOURNAL_COMPACT_RECORDS = 65536;
+    QueueJournal journal;
+    std::string journalRecords; // Records being appended, reused between calls
 
-    // File pointer for admission log (admitted_viewers.csv)
-    std::FILE* admitLog;
+    // Add an E (enqueued), D (admitted), R (removed) or P (priority changed)
+    // record for v to journalRecords
+    void journalViewer(char op, const Viewer* v);
+    // Append journalRecords to the log, compacting it if it has grown
+    void commitJournal();
+    void replayJournal(const std::string& log);
+    // The queued viewer with this ID and arrivalOrder, or NO_HANDLE; O(n)
+    // for a viewer whose ID a later viewer shadows in the index
+    ViewerHandle findQueued(const std::string& id, int arrivalOrder) const;
+    // Parse "ViewerID,ViewerName,Priority[,ArrivalOrder]" rows into viewers;
+    // returns how many. Exits on a malformed row.
+    static int parseViewerRows(const char* p, const char* end, Viewer* viewers, bool withArrival);
 
     // Helper to parse CSV line into fields
     void parseLine(const std::string& line, std::string* fields, int expectedFields);
@@ -0,0 +1,38 @@
+#pragma once
+
+// Constant-memory histogram of durations in nanoseconds, log-linear in the
+// style of HdrHistogram. Values below 64 ns have a bucket each; above that
+// every power of two is split into SUB_BUCKETS equal buckets, so a
+// percentile is reported within 1/SUB_BUCKETS (about 3%) of the true value.
+class WaitHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 5;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    // Enough buckets for every non-negative long long
+    static const int BUCKETS = (64 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    WaitHistogram();
+
+    // Adds one duration; negative values count as 0
+    void record(long long nanoseconds);
+    void clear();
+
+    long long count() const { return total; }
+    long long min() const { return total > 0 ? minValue : 0; }
+    long long max() const { return maxValue; }
+    double mean() const { return total > 0 ? sum / total : 0.0; }
+    // Smallest value at or below which percent% of the recorded values lie,
+    // to bucket precision (never above max()); 0 if nothing was recorded
+    long long percentile(double percent) const;
+
+private:
+    long long counts[BUCKETS];
+    long long total;
+    long long minValue;
+    long long maxValue;
+    double sum;
+
+    static int bucketOf(long long value);
+    // Largest value that falls in bucket
+    static long long highestIn(int bucket);
+};
@@ -0,0 +1,239 @@
+#include "admission_log.hpp"
+#include <chrono>
+#include <cstring>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+const char* durabilityName(LogDurability durability) {
+    switch (durability) {
+        case LogDurability::None: return "none";
+        case LogDurability::Batched: return "batched";
+        case LogDurability::PerRecord: return "per-record";
+    }
+    return "unknown";
+}
+
+// Forces the file's written data to stable storage
+static void syncFile(std::FILE* file) {
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+}
+
+AdmissionLog::AdmissionLog()
+    : file(nullptr), durability(LogDurability::Batched)
+{
+}
+
+AdmissionLog::~AdmissionLog() {
+    close();
+}
+
+bool AdmissionLog::open(const std::string& filename, LogDurability level) {
+    close();
+    file = std::fopen(filename.c_str(), "a");
+    if (!file) return false;
+    durability = level;
+    // If the file is brand-new (size 0), write header
+    std::fseek(file, 0, SEEK_END);
+    if (std::ftell(file) == 0) {
+        std::fprintf(file, "ViewerID,ViewerName,Priority,AdmitTime,ChannelID\n");
+        std::fflush(file);
+    }
+    writer.start(file, durability);
+    return true;
+}
+
+void AdmissionLog::close() {
+    if (!file) return;
+    writer.stop();
+    std::fclose(file);
+    file = nullptr;
+}
+
+void AdmissionLog::append(const std::string& viewerID, const std::string& viewerName, int priority,
+                          const std::string& admitTime, const std::string& channelID) {
+    if (!file) return;
+    lines.clear();
+    formatLine(lines, viewerID, viewerName, priority, admitTime, channelID);
+    writer.write(lines.data(), lines.size());
+}
+
+void AdmissionLog::appendBatch(Viewer* const* viewers, const std::string* const* channelIDs, int count,
+                               const std::string& admitTime) {
+    if (!file || count <= 0) return;
+    lines.clear();
+    for (int i = 0; i < count; i++) {
+        formatLine(lines, viewers[i]->id, viewers[i]->name, viewers[i]->priority, admitTime, *channelIDs[i]);
+    }
+    writer.write(lines.data(), lines.size());
+}
+
+void AdmissionLog::formatLine(std::string& out, const std::string& viewerID, const std::string& viewerName,
+                              int priority, const std::string& admitTime, const std::string& channelID) {
+    char line[256];
+    int length = std::snprintf(line, sizeof(line), "%s,%s,%d,%s,%s\n",
+                               viewerID.c_str(), viewerName.c_str(), priority,
+                               admitTime.c_str(), channelID.c_str());
+    if (length < 0) return;
+    if (static_cast<size_t>(length) < sizeof(line)) {
+        out.append(line, length);
+        return;
+    }
+    // Rare: a name too long for the stack buffer
+    size_t at = out.size();
+    out.resize(at + length + 1);
+    std::snprintf(&out[at], length + 1, "%s,%s,%d,%s,%s\n",
+                  viewerID.c_str(), viewerName.c_str(), priority,
+                  admitTime.c_str(), channelID.c_str());
+    out.resize(at + length);
+}
+
+void AdmissionLog::flush() {
+    if (!file) return;
+    writer.flush();
+}
+
+LogWriter::LogWriter()
+    : file(nullptr), durability(LogDurability::Batched), ring(nullptr),
+      head(0), tail(0), committed(0), notifiedAt(0), stopping(false), flushRequested(false)
+{
+}
+
+LogWriter::~LogWriter() {
+    stop();
+}
+
+void LogWriter::start(std::FILE* target, LogDurability level) {
+    stop();
+    file = target;
+    durability = level;
+    if (durability != LogDurability::PerRecord) {
+        ring = new char[RING_BYTES];
+        head.store(0);
+        tail.store(0);
+        committed.store(0);
+        notifiedAt = 0;
+        stopping.store(false);
+        flushRequested.store(false);
+        writer = std::thread(&LogWriter::writerLoop, this);
+    }
+}
+
+void LogWriter::stop() {
+    if (writer.joinable()) {
+        stopping.store(true, std::memory_order_release);
+        wake.notify_one();
+        writer.join();
+    }
+    delete[] ring;
+    ring = nullptr;
+    file = nullptr;
+}
+
+void LogWriter::write(const char* text, size_t length) {
+    if (durability == LogDurability::PerRecord) {
+        std::fwrite(text, 1, length, file);
+        std::fflush(file);
+        syncFile(file);
+    } else {
+        push(text, length);
+    }
+}
+
+void LogWriter::flush() {
+    if (durability == LogDurability::PerRecord) return;  // Already committed by write()
+    size_t target = head.load(std::memory_order_relaxed);
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    flushRequested.store(true, std::memory_order_release);
+    wake.notify_one();
+    drained.wait(lock, [&] { return committed.load(std::memory_order_acquire) >= target; });
+}
+
+void LogWriter::push(const char* text, size_t length) {
+    size_t h = head.load(std::memory_order_relaxed);
+    while (length > 0) {
+        size_t space = RING_BYTES - (h - tail.load(std::memory_order_acquire));
+        if (space == 0) {
+            // Ring full: let the writer catch up
+            wake.notify_one();
+            std::this_thread::yield();
+            continue;
+        }
+        size_t n = length < space ? length : space;
+        size_t offset = h & (RING_BYTES - 1);
+        size_t first = n < RING_BYTES - offset ? n : RING_BYTES - offset;
+        std::memcpy(ring + offset, text, first);
+        std::memcpy(ring, text + first, n - first);
+        h += n;
+        text += n;
+        length -= n;
+        head.store(h, std::memory_order_release);
+    }
+    // Wake the writer once per full batch rather than per record
+    if (h - notifiedAt >= BATCH_BYTES) {
+        notifiedAt = h;
+        wake.notify_one();
+    }
+}
+
+void LogWriter::writerLoop() {
+    typedef std::chrono::steady_clock Clock;
+    const Clock::duration interval = std::chrono::milliseconds(FLUSH_INTERVAL_MS);
+    size_t written = tail.load(std::memory_order_relaxed);
+    Clock::time_point lastCommit = Clock::now();
+
+    while (true) {
+        // Read stopping before head so a stop request sees every record pushed before it
+        bool stop = stopping.load(std::memory_order_acquire);
+        bool flushNow = flushRequested.exchange(false, std::memory_order_acq_rel);
+        size_t end = head.load(std::memory_order_acquire);
+        size_t pending = end - written;
+        Clock::time_point now = Clock::now();
+
+        if (pending > 0 && (pending >= BATCH_BYTES || now - lastCommit >= interval || stop || flushNow)) {
+            writeRange(written, end);
+            written = end;
+            tail.store(end, std::memory_order_release);  // fwrite copied the bytes out
+            commit();
+            lastCommit = now;
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex);
+                committed.store(end, std::memory_order_release);
+            }
+            drained.notify_all();
+            continue;
+        }
+        if (flushNow) {
+            // Nothing was pending: the caller's records are already committed
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            drained.notify_all();
+        }
+        if (stop) break;
+
+        // Sleep until the batch is due. A missed wake-up only delays the
+        // batch until the interval expires.
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wake.wait_until(lock, (pending > 0 ? lastCommit : now) + interval);
+    }
+}
+
+void LogWriter::writeRange(size_t from, size_t to) {
+    while (from < to) {
+        size_t offset = from & (RING_BYTES - 1);
+        size_t n = to - from;
+        if (n > RING_BYTES - offset) n = RING_BYTES - offset;
+        std::fwrite(ring + offset, 1, n, file);
+        from += n;
+    }
+}
+
+void LogWriter::commit() {
+    std::fflush(file);
+    if (durability == LogDurability::Batched) syncFile(file);
+}
@@ -0,0 +1,89 @@
+#include "concurrent_spectator_queue.hpp"
+#include <thread>
+
+ConcurrentSpectatorQueue::ConcurrentSpectatorQueue(const std::string& logFile, LogDurability durability,
+                                                   QueueMode mode, DuplicateGuard guard)
+    : gateCount(0), queue(logFile, durability, mode, guard), mergeCounter(0)
+{
+    for (int g = 0; g < MAX_GATES; g++) {
+        gates[g].ring.store(nullptr);
+        gates[g].head.store(0);
+        gates[g].tail.store(0);
+    }
+}
+
+ConcurrentSpectatorQueue::~ConcurrentSpectatorQueue() {
+    // Viewers still waiting at a gate are owned by the queue too
+    mergeGates();
+    for (int g = 0; g < MAX_GATES; g++) {
+        delete[] gates[g].ring.load();
+    }
+}
+
+int ConcurrentSpectatorQueue::openGate() {
+    int gate = gateCount.fetch_add(1, std::memory_order_relaxed);
+    if (gate >= MAX_GATES) return -1;
+    // The admission thread skips the gate until its ring is published
+    gates[gate].ring.store(new Viewer*[GATE_RING_SIZE], std::memory_order_release);
+    return gate;
+}
+
+void ConcurrentSpectatorQueue::enqueueViewer(int gate, Viewer* v) {
+    Gate& g = gates[gate];
+    Viewer** ring = g.ring.load(std::memory_order_relaxed);
+    unsigned tail = g.tail.load(std::memory_order_relaxed);
+    while (tail - g.head.load(std::memory_order_acquire) == GATE_RING_SIZE) {
+        // Ring full: wait for the admission thread to merge
+        std::this_thread::yield();
+    }
+    ring[tail & (GATE_RING_SIZE - 1)] = v;
+    g.tail.store(tail + 1, std::memory_order_release);
+}
+
+int ConcurrentSpectatorQueue::mergeGates() {
+    int moved = 0;
+    int open = openGates();
+    for (int gate = 0; gate < open; gate++) {
+        Gate& g = gates[gate];
+        Viewer** ring = g.ring.load(std::memory_order_acquire);
+        if (ring == nullptr) continue;
+        unsigned head = g.head.load(std::memory_order_relaxed);
+        unsigned tail = g.tail.load(std::memory_order_acquire);
+        for (; head != tail; head++) {
+            Viewer* v = ring[head & (GATE_RING_SIZE - 1)];
+            v->arrivalOrder = mergeCounter++;
+            if (queue.enqueueViewer(v) == NO_HANDLE) {
+                queue.releaseViewer(v);     // Duplicate ID
+                continue;
+            }
+            moved++;
+        }
+        g.head.store(head, std::memory_order_release);
+    }
+    return moved;
+}
+
+Viewer* ConcurrentSpectatorQueue::dequeueViewer() {
+    mergeGates();
+    return queue.dequeueViewer();
+}
+
+int ConcurrentSpectatorQueue::admitBatch(int n, Viewer** out) {
+    mergeGates();
+    return queue.admitBatch(n, out);
+}
+
+int ConcurrentSpectatorQueue::size() {
+    int waiting = 0;
+    int open = openGates();
+    for (int gate = 0; gate < open; gate++) {
+        waiting += static_cast<int>(gates[gate].tail.load(std::memory_order_acquire) -
+                                    gates[gate].head.load(std::memory_order_relaxed));
+    }
+    return queue.size() + waiting;
+}
+
+int ConcurrentSpectatorQueue::openGates() const {
+    int open = gateCount.load(std::memory_order_relaxed);
+    return open < MAX_GATES ? open : MAX_GATES;
+}
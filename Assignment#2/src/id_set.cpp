@@ -0,0 +1,145 @@
+#include "id_set.hpp"
+#include <cstring>
+
+static const int INITIAL_CAPACITY = 64;
+static const int BLOOM_PROBES = 4;
+
+IdSet::IdSet(bool bloomPrefilter)
+    : capacity(INITIAL_CAPACITY), count(0), arenaSize(1), arenaCapacity(1024), bloom(nullptr)
+{
+    table = new Slot[capacity];
+    for (int i = 0; i < capacity; i++) {
+        table[i].offset = 0;
+    }
+    arena = new char[arenaCapacity];
+    arena[0] = '\0';
+    if (bloomPrefilter) {
+        bloom = new unsigned char[capacity];
+        std::memset(bloom, 0, capacity);
+    }
+}
+
+IdSet::~IdSet() {
+    delete[] table;
+    delete[] arena;
+    delete[] bloom;
+}
+
+bool IdSet::contains(const std::string& id) const {
+    unsigned hash = hashID(id.data(), id.size());
+    if (bloom && !bloomMayContain(hash)) return false;
+    return table[find(id, hash)].offset != 0;
+}
+
+bool IdSet::insert(const std::string& id) {
+    unsigned hash = hashID(id.data(), id.size());
+    int i = find(id, hash);
+    if (table[i].offset != 0) return false;
+    if (2 * (count + 1) > capacity) {
+        grow();
+        i = find(id, hash);
+    }
+    size_t needed = arenaSize + id.size() + 1;
+    if (needed > arenaCapacity) {
+        size_t newCap = arenaCapacity * 2;
+        while (newCap < needed) newCap *= 2;
+        char* newArena = new char[newCap];
+        std::memcpy(newArena, arena, arenaSize);
+        delete[] arena;
+        arena = newArena;
+        arenaCapacity = newCap;
+    }
+    table[i].hash = hash;
+    table[i].offset = static_cast<unsigned>(arenaSize);
+    std::memcpy(arena + arenaSize, id.data(), id.size());
+    arena[arenaSize + id.size()] = '\0';
+    arenaSize = needed;
+    count++;
+    if (bloom) bloomAdd(hash);
+    return true;
+}
+
+void IdSet::clear() {
+    for (int i = 0; i < capacity; i++) {
+        table[i].offset = 0;
+    }
+    if (bloom) std::memset(bloom, 0, capacity);
+    arenaSize = 1;
+    count = 0;
+}
+
+size_t IdSet::memoryBytes() const {
+    return capacity * sizeof(Slot) + arenaCapacity + (bloom ? capacity : 0);
+}
+
+unsigned IdSet::hashID(const char* data, size_t length) {
+    // FNV-1a
+    unsigned hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+int IdSet::find(const std::string& id, unsigned hash) const {
+    int mask = capacity - 1;
+    int i = hash & mask;
+    while (table[i].offset != 0 && !matches(table[i], id, hash)) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+bool IdSet::matches(const Slot& slot, const std::string& id, unsigned hash) const {
+    // Compares the terminating '\0' too, and never reads past the stored ID
+    return slot.hash == hash && std::strncmp(arena + slot.offset, id.c_str(), id.size() + 1) == 0;
+}
+
+void IdSet::grow() {
+    // The stored hashes are enough to rehash the table and refill the filter
+    int oldCap = capacity;
+    Slot* oldTable = table;
+    capacity *= 2;
+    table = new Slot[capacity];
+    for (int i = 0; i < capacity; i++) {
+        table[i].offset = 0;
+    }
+    if (bloom) {
+        delete[] bloom;
+        bloom = new unsigned char[capacity];
+        std::memset(bloom, 0, capacity);
+    }
+    int mask = capacity - 1;
+    for (int i = 0; i < oldCap; i++) {
+        if (oldTable[i].offset == 0) continue;
+        int j = oldTable[i].hash & mask;
+        while (table[j].offset != 0) {
+            j = (j + 1) & mask;
+        }
+        table[j] = oldTable[i];
+        if (bloom) bloomAdd(oldTable[i].hash);
+    }
+    delete[] oldTable;
+}
+
+// Probe k of the filter is (hash + k * step) mod bits, with step an odd
+// remix of the hash (double hashing)
+void IdSet::bloomAdd(unsigned hash) {
+    unsigned mask = static_cast<unsigned>(capacity) * 8 - 1;
+    unsigned step = ((hash >> 16) | (hash << 16)) * 0x85EBCA6Bu | 1u;
+    for (int k = 0; k < BLOOM_PROBES; k++) {
+        unsigned bit = (hash + k * step) & mask;
+        bloom[bit >> 3] |= static_cast<unsigned char>(1u << (bit & 7));
+    }
+}
+
+bool IdSet::bloomMayContain(unsigned hash) const {
+    unsigned mask = static_cast<unsigned>(capacity) * 8 - 1;
+    unsigned step = ((hash >> 16) | (hash << 16)) * 0x85EBCA6Bu | 1u;
+    for (int k = 0; k < BLOOM_PROBES; k++) {
+        unsigned bit = (hash + k * step) & mask;
+        if (!(bloom[bit >> 3] & (1u << (bit & 7)))) return false;
+    }
+    return true;
+}
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <string>
+#include <fstream>
 #include "spectator_queue.hpp"
 #include "match_scheduler.hpp"
 #include "tournament_registration.hpp"
@@ -7,7 +8,7 @@
 /*
 # To build and run your project manually, use the following command from the project root:
 #
-# g++ -std=c++11 -Iinclude src/main.cpp src/spectator_queue.cpp src/match_scheduler.cpp src/tournament_registration.cpp -o apuec_system
+# g++ -std=c++11 -pthread -Iinclude src/main.cpp src/spectator_queue.cpp src/admission_log.cpp src/queue_journal.cpp src/wait_histogram.cpp src/id_set.cpp src/match_scheduler.cpp src/tournament_registration.cpp -o apuec_system
 #
 # Then run:
 # ./apuec_system
@@ -19,7 +20,13 @@ int main() {
     TournamentRegistration registration;
     
     // Load data
-    spectatorQueue.loadViewers("data/viewers.csv");
+    // Pick up the line where the last run left it, if there was one
+    if (!spectatorQueue.openJournal("data/spectator_queue")) {
+        int skipped = spectatorQueue.loadViewers("data/viewers.csv");
+        if (skipped > 0) {
+            std::cout << "Skipped " << skipped << " duplicate viewer rows.\n";
+        }
+    }
     spectatorQueue.loadSlots("data/stream_slots.csv");
     
     matchScheduler.loadTeams("data/teams.csv");
@@ -34,8 +41,10 @@ int main() {
         std::cout << "1) Registration (Task 2)\n";
         std::cout << "2) Match Scheduling (Task 1)\n";
         std::cout << "3) Admit Next Spectator (Task 3)\n";
-        std::cout << "4) View Queue Size\n";
-        std::cout << "5) End Tournament\n";
+        std::cout << "4) Admit Spectator Wave\n";
+        std::cout << "5) Spectator Queue Tools\n";
+        std::cout << "6) View Queue Size\n";
+        std::cout << "7) End Tournament\n";
         std::cout << "Select an option: ";
 
         int choice;
@@ -172,12 +181,104 @@ int main() {
                                   << " (Priority " 
                                   << next->priority 
                                   << ")\n";
-                        delete next; // Free memory after admission
+                        spectatorQueue.releaseViewer(next); // Free memory after admission
                     }
                 }
                 break;
             }
             case 4: {
+                std::cout << "Enter wave size: ";
+                int waveSize;
+                std::cin >> waveSize;
+                if (spectatorQueue.isEmpty()) {
+                    std::cout << "No spectators waiting.\n";
+                } else if (waveSize > 0) {
+                    Viewer** wave = new Viewer*[waveSize];
+                    int admitted = spectatorQueue.admitBatch(waveSize, wave);
+                    for (int i = 0; i < admitted; i++) {
+                        std::cout << "Admitted "
+                                  << wave[i]->name
+                                  << " (Priority "
+                                  << wave[i]->priority
+                                  << ")\n";
+                        spectatorQueue.releaseViewer(wave[i]); // Free memory after admission
+                    }
+                    delete[] wave;
+                    std::cout << admitted << " spectators admitted.\n";
+                }
+                break;
+            }
+            case 5: {
+                // Spectator queue submenu
+                bool toolsActive = true;
+                while (toolsActive) {
+                    std::cout << "\n=== Spectator Queue Tools ===\n";
+                    std::cout << "1) Change Spectator Priority\n";
+                    std::cout << "2) Remove Spectator From Line\n";
+                    std::cout << "3) Show Wait Times\n";
+                    std::cout << "4) Export Wait Times\n";
+                    std::cout << "5) Back to Main Menu\n";
+                    std::cout << "Select option: ";
+
+                    int toolChoice;
+                    std::cin >> toolChoice;
+
+                    switch (toolChoice) {
+                        case 1: {
+                            std::cout << "Enter Viewer ID: ";
+                            std::string viewerID;
+                            std::cin >> viewerID;
+                            std::cout << "Enter new priority (1 VIP, 2 Influencer, 3 Usual): ";
+                            int priority;
+                            std::cin >> priority;
+                            ViewerHandle h = spectatorQueue.findViewer(viewerID);
+                            if (h == NO_HANDLE) {
+                                std::cout << "Viewer " << viewerID << " is not in the queue.\n";
+                            } else {
+                                spectatorQueue.changePriority(h, priority);
+                                std::cout << "Viewer " << viewerID << " now has priority " << priority << ".\n";
+                            }
+                            break;
+                        }
+                        case 2: {
+                            std::cout << "Enter Viewer ID: ";
+                            std::string viewerID;
+                            std::cin >> viewerID;
+                            Viewer* left = spectatorQueue.removeViewer(spectatorQueue.findViewer(viewerID));
+                            if (!left) {
+                                std::cout << "Viewer " << viewerID << " is not in the queue.\n";
+                            } else {
+                                std::cout << left->name << " left the line.\n";
+                                spectatorQueue.releaseViewer(left);
+                            }
+                            break;
+                        }
+                        case 3: {
+                            std::cout << "Wait from joining the line to admission:\n";
+                            spectatorQueue.printWaitTimes(std::cout);
+                            break;
+                        }
+                        case 4: {
+                            std::ofstream dump("data/wait_times.csv");
+                            if (!dump.is_open()) {
+                                std::cout << "Could not write data/wait_times.csv.\n";
+                            } else {
+                                spectatorQueue.dumpWaitTimes(dump);
+                                std::cout << "Wait times written to data/wait_times.csv.\n";
+                            }
+                            break;
+                        }
+                        case 5: {
+                            toolsActive = false;
+                            break;
+                        }
+                        default:
+                            std::cout << "Invalid choice.\n";
+                    }
+                }
+                break;
+            }
+            case 6: {
                 std::cout << "Currently " 
                           << spectatorQueue.size() 
                           << " spectators in queue.\n";
@@ -186,8 +287,9 @@ int main() {
                           << " matches scheduled.\n";
                 break;
             }
-            case 5: {
+            case 7: {
                 std::cout << "Ending tournament. Clearing queues...\n";
+                spectatorQueue.discardJournal();    // The next run starts a new line
                 spectatorQueue.clearAll();
                 matchScheduler.clearAll();
                 running = false;
@@ -0,0 +1,204 @@
+#include "queue_journal.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <cstdlib>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Forces the file's written data to stable storage
+static void syncFile(std::FILE* file) {
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+}
+
+// Whole file into text; false if it cannot be opened
+static bool readFile(const std::string& filename, std::string& text) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+    file.seekg(0, std::ios::end);
+    std::streamoff length = file.tellg();
+    file.seekg(0, std::ios::beg);
+    text.clear();
+    if (length > 0) {
+        text.resize(static_cast<size_t>(length));
+        file.read(&text[0], length);
+    }
+    return true;
+}
+
+// Parses a snapshot file; false unless its header and every row are complete
+static bool parseSnapshot(const std::string& text, int& generation, int& rowCount, int& arrivalCounter,
+                          long long& admitStart, size_t& rowsStart) {
+    if (std::sscanf(text.c_str(), "SNAPSHOT,%d,%d,%d,%lld", &generation, &rowCount, &arrivalCounter,
+                    &admitStart) != 4) {
+        return false;
+    }
+    rowsStart = text.find('\n');
+    if (rowsStart == std::string::npos || text[text.size() - 1] != '\n') return false;
+    rowsStart++;
+    return std::count(text.begin() + rowsStart, text.end(), '\n') == rowCount;
+}
+
+QueueJournal::QueueJournal()
+    : log(nullptr), durability(LogDurability::Batched), generation(0), admitStart(0), records(0), logIntact(false)
+{
+}
+
+QueueJournal::~QueueJournal() {
+    close();
+}
+
+bool QueueJournal::read(const std::string& journalBase, std::string& rows, int& rowCount, int& arrivalCounter,
+                        long long& lineAdmitStart, std::string& logRecords) {
+    base = journalBase;
+    generation = 0;
+    admitStart = 0;
+    rowCount = 0;
+    arrivalCounter = 0;
+    rows.clear();
+    logRecords.clear();
+
+    // The installed snapshot, or one that was written out in full but not
+    // yet renamed into place when the process stopped
+    std::string text;
+    size_t rowsStart = 0;
+    bool installed = readFile(snapshotPath(), text);
+    bool found = installed && parseSnapshot(text, generation, rowCount, arrivalCounter, admitStart, rowsStart);
+    if (!found && readFile(snapshotPath() + ".tmp", text)) {
+        found = parseSnapshot(text, generation, rowCount, arrivalCounter, admitStart, rowsStart);
+    }
+    if (!found && installed) {
+        std::cerr << "Corrupt snapshot " << snapshotPath() << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    if (found) {
+        rows.assign(text, rowsStart, std::string::npos);
+    } else {
+        generation = 0;
+        admitStart = 0;
+        rowCount = 0;
+        arrivalCounter = 0;
+    }
+
+    validLog.clear();
+    logIntact = false;
+    if (readFile(logPath(), text)) {
+        int logGeneration = -1;
+        long long logAdmitStart = 0;
+        size_t recordsStart = text.find('\n');
+        if (std::sscanf(text.c_str(), "OPLOG,%d,%lld", &logGeneration, &logAdmitStart) == 2 &&
+            logGeneration == generation && recordsStart != std::string::npos) {
+            if (!found) admitStart = logAdmitStart;
+            // Keep whole records only; the last may have been cut off mid-write
+            size_t end = text.rfind('\n') + 1;
+            validLog.assign(text, recordsStart + 1, end - recordsStart - 1);
+            logIntact = end == text.size();
+        }
+    }
+    logRecords = validLog;
+    lineAdmitStart = admitStart;
+    return found || !validLog.empty();
+}
+
+bool QueueJournal::open(const std::string& journalBase, LogDurability level, long long lineAdmitStart) {
+    close();
+    base = journalBase;
+    durability = level;
+    admitStart = lineAdmitStart;
+    records = std::count(validLog.begin(), validLog.end(), '\n');
+    if (logIntact) {
+        log = std::fopen(logPath().c_str(), "ab");
+        validLog.clear();
+        if (!log) return false;
+        writer.start(log, durability);
+        return true;
+    }
+    bool started = startLog(validLog);
+    validLog.clear();
+    return started;
+}
+
+bool QueueJournal::startLog(const std::string& text) {
+    log = std::fopen(logPath().c_str(), "wb");
+    if (!log) return false;
+    std::fprintf(log, "OPLOG,%d,%lld\n", generation, admitStart);
+    std::fwrite(text.data(), 1, text.size(), log);
+    std::fflush(log);
+    syncFile(log);
+    logIntact = true;
+    writer.start(log, durability);
+    return true;
+}
+
+void QueueJournal::append(const std::string& text) {
+    if (!log || text.empty()) return;
+    writer.write(text.data(), text.size());
+    records += std::count(text.begin(), text.end(), '\n');
+}
+
+void QueueJournal::flush() {
+    if (!log) return;
+    writer.flush();
+}
+
+void QueueJournal::writeSnapshot(const std::string& rows, int rowCount, int arrivalCounter) {
+    if (!log) return;
+    // Write the whole snapshot under a temporary name, then rename it over
+    // the old one so a crash leaves one complete snapshot or the other
+    std::string tmpPath = snapshotPath() + ".tmp";
+    std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (!file) {
+        std::perror(("Error writing " + tmpPath).c_str());
+        std::exit(EXIT_FAILURE);
+    }
+    std::fprintf(file, "SNAPSHOT,%d,%d,%d,%lld\n", generation + 1, rowCount, arrivalCounter, admitStart);
+    std::fwrite(rows.data(), 1, rows.size(), file);
+    std::fflush(file);
+    syncFile(file);
+    std::fclose(file);
+#ifdef _WIN32
+    // rename does not replace on Windows; read() falls back to the .tmp file
+    std::remove(snapshotPath().c_str());
+#endif
+    if (std::rename(tmpPath.c_str(), snapshotPath().c_str()) != 0) {
+        std::perror(("Error installing " + snapshotPath()).c_str());
+        std::exit(EXIT_FAILURE);
+    }
+
+    // The old log is now ignored: its generation no longer matches
+    generation++;
+    writer.stop();
+    std::fclose(log);
+    log = nullptr;
+    if (!startLog("")) {
+        std::perror(("Error opening " + logPath()).c_str());
+        std::exit(EXIT_FAILURE);
+    }
+    records = 0;
+}
+
+void QueueJournal::close() {
+    if (!log) return;
+    writer.stop();
+    std::fflush(log);
+    if (durability != LogDurability::None) syncFile(log);
+    std::fclose(log);
+    log = nullptr;
+}
+
+void QueueJournal::discard() {
+    close();
+    std::remove(snapshotPath().c_str());
+    std::remove((snapshotPath() + ".tmp").c_str());
+    std::remove(logPath().c_str());
+    generation = 0;
+    admitStart = 0;
+    records = 0;
+}
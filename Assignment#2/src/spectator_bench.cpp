@@ -0,0 +1,1425 @@
+// Spectator queue benchmark: admits synthetic viewers through SpectatorQueue
+// and reports admissions per second for each admission-log durability level.
+//
+// Build: g++ -std=c++11 -O2 -pthread -Iinclude src/spectator_bench.cpp src/spectator_queue.cpp src/admission_log.cpp src/queue_journal.cpp src/wait_histogram.cpp src/id_set.cpp src/concurrent_spectator_queue.cpp -o spectator_bench
+// Run:   ./spectator_bench [viewers] [wave] [structureViewers] [loadViewers] [journalViewers] [guardIDs]
+//        ./spectator_bench --stress [rounds]   (checks ConcurrentSpectatorQueue under load)
+//        ./spectator_bench --check             (regression checks against reference models)
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+#include <set>
+#include <map>
+#include <tuple>
+#include <climits>
+#include <cmath>
+#include "spectator_queue.hpp"
+#include "concurrent_spectator_queue.hpp"
+
+static const char* BENCH_LOG = "spectator_bench_log.csv";
+
+typedef std::chrono::steady_clock Clock;
+
+static double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Viewer i with a repeatable pseudo-random tier
+static Viewer* makeViewer(int i) {
+    Viewer* v = new Viewer;
+    v->id = "V" + std::to_string(i);
+    v->name = "Viewer " + std::to_string(i);
+    v->priority = 1 + static_cast<int>((i * 2654435761u) >> 16) % 3;
+    v->arrivalOrder = i;
+    return v;
+}
+
+static void printRow(const std::string& label, int viewers, double admitMs, double totalMs) {
+    std::cout << std::left << std::setw(24) << label
+              << std::right << std::setw(10) << viewers
+              << std::fixed << std::setprecision(1)
+              << std::setw(12) << admitMs
+              << std::setw(14) << std::setprecision(0) << viewers / (admitMs / 1000.0)
+              << std::setw(12) << std::setprecision(1) << totalMs << "\n";
+}
+
+static void printHeader(const std::string& title) {
+    std::cout << "\n" << title << "\n";
+    std::cout << std::left << std::setw(24) << "Durability" << std::right << std::setw(10) << "Viewers"
+              << std::setw(12) << "Admit" << std::setw(14) << "Admits/s" << std::setw(12) << "Total" << "\n";
+    std::cout << std::string(72, '-') << "\n";
+}
+
+static Viewer** makeViewers(int viewers) {
+    Viewer** list = new Viewer*[viewers];
+    for (int i = 0; i < viewers; i++) list[i] = makeViewer(i);
+    return list;
+}
+
+static void deleteViewers(Viewer** list, int viewers) {
+    for (int i = 0; i < viewers; i++) delete list[i];
+    delete[] list;
+}
+
+// The log writes of the old dequeueViewer: fprintf and fflush per admission
+// on the admitting thread
+static void runUnbatchedLog(int viewers) {
+    std::remove(BENCH_LOG);
+    std::FILE* log = std::fopen(BENCH_LOG, "a");
+    if (!log) {
+        std::perror(BENCH_LOG);
+        std::exit(EXIT_FAILURE);
+    }
+    Viewer** admitted = makeViewers(viewers);
+
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < viewers; i++) {
+        Viewer* v = admitted[i];
+        std::fprintf(log, "%s,%s,%d,%s,%s\n", v->id.c_str(), v->name.c_str(), v->priority,
+                     "2025-06-15T00:00", "ChannelX");
+        std::fflush(log);
+    }
+    double ms = millisecondsSince(start);
+    std::fclose(log);
+    deleteViewers(admitted, viewers);
+    printRow("fflush per record (old)", viewers, ms, ms);
+}
+
+// The same records through AdmissionLog
+static void runLog(LogDurability durability, int viewers) {
+    std::remove(BENCH_LOG);
+    Viewer** admitted = makeViewers(viewers);
+    static const std::string admitTime = "2025-06-15T00:00";
+    static const std::string channelID = "ChannelX";
+    Clock::time_point start;
+    double admitMs;
+    {
+        AdmissionLog log;
+        if (!log.open(BENCH_LOG, durability)) {
+            std::perror(BENCH_LOG);
+            std::exit(EXIT_FAILURE);
+        }
+        start = Clock::now();
+        for (int i = 0; i < viewers; i++) {
+            Viewer* v = admitted[i];
+            log.append(v->id, v->name, v->priority, admitTime, channelID);
+        }
+        admitMs = millisecondsSince(start);
+        log.flush();
+    }
+    printRow(durabilityName(durability), viewers, admitMs, millisecondsSince(start));
+    deleteViewers(admitted, viewers);
+}
+
+// Full admissions: heap pop, log record and freeing the viewer
+static void runDequeue(LogDurability durability, int viewers) {
+    std::remove(BENCH_LOG);
+    Clock::time_point start;
+    double admitMs;
+    {
+        SpectatorQueue queue(BENCH_LOG, durability);
+        for (int i = 0; i < viewers; i++) queue.enqueueViewer(makeViewer(i));
+
+        start = Clock::now();
+        for (int i = 0; i < viewers; i++) delete queue.dequeueViewer();
+        admitMs = millisecondsSince(start);
+        queue.flushAdmissionLog();
+    }
+    printRow(durabilityName(durability), viewers, admitMs, millisecondsSince(start));
+}
+
+// Admits one wave of waveSize viewers from a queue of viewers, one at a time
+// or with admitBatch. Times include the log commit.
+static void runWave(int viewers, int waveSize, bool batch) {
+    std::remove(BENCH_LOG);
+    Viewer** wave = new Viewer*[waveSize];
+    double ms;
+    int admitted = 0;
+    {
+        SpectatorQueue queue(BENCH_LOG, LogDurability::Batched);
+        for (int i = 0; i < viewers; i++) queue.enqueueViewer(makeViewer(i));
+
+        Clock::time_point start = Clock::now();
+        if (batch) {
+            admitted = queue.admitBatch(waveSize, wave);
+        } else {
+            while (admitted < waveSize && !queue.isEmpty()) wave[admitted++] = queue.dequeueViewer();
+        }
+        queue.flushAdmissionLog();
+        ms = millisecondsSince(start);
+    }
+    std::cout << std::left << std::setw(24) << (batch ? "admitBatch" : "dequeueViewer loop")
+              << std::right << std::setw(10) << viewers << std::setw(10) << admitted
+              << std::fixed << std::setprecision(2) << std::setw(12) << ms << "\n";
+    for (int i = 0; i < admitted; i++) delete wave[i];
+    delete[] wave;
+}
+
+// Enqueues then dequeues every viewer with the admission log disabled, so
+// only the queue structure is timed
+static void runStructure(QueueMode mode, Viewer** viewers, int count) {
+    SpectatorQueue queue("", LogDurability::None, mode);
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < count; i++) queue.enqueueViewer(viewers[i]);
+    double enqueueMs = millisecondsSince(start);
+
+    start = Clock::now();
+    bool ordered = true;
+    Viewer* previous = nullptr;
+    for (int i = 0; i < count; i++) {
+        Viewer* v = queue.dequeueViewer();
+        if (previous && (v->priority < previous->priority ||
+                         (v->priority == previous->priority && v->arrivalOrder < previous->arrivalOrder))) {
+            ordered = false;
+        }
+        previous = v;
+    }
+    double dequeueMs = millisecondsSince(start);
+
+    std::cout << std::left << std::setw(24) << (mode == QueueMode::Buckets ? "buckets" : "binary heap")
+              << std::right << std::setw(10) << count
+              << std::fixed << std::setprecision(1)
+              << std::setw(12) << enqueueMs << std::setw(12) << dequeueMs
+              << std::setw(10) << (ordered ? "yes" : "NO") << "\n";
+}
+
+// Gate threads enqueue `total` viewers between them while one admission
+// thread dequeues. Sharded uses ConcurrentSpectatorQueue; otherwise every
+// operation locks one mutex around a SpectatorQueue.
+static void runGates(int producers, Viewer** crowd, int total, bool sharded) {
+    ConcurrentSpectatorQueue shardedQueue("", LogDurability::None);
+    SpectatorQueue lockedQueue("", LogDurability::None);
+    std::mutex lock;
+    std::atomic<bool> go(false);
+    std::atomic<int> ready(0);
+
+    std::vector<std::thread> gates;
+    for (int p = 0; p < producers; p++) {
+        gates.push_back(std::thread([&, p] {
+            int gate = sharded ? shardedQueue.openGate() : -1;
+            int from = static_cast<int>(static_cast<long long>(total) * p / producers);
+            int to = static_cast<int>(static_cast<long long>(total) * (p + 1) / producers);
+            ready++;
+            while (!go.load()) std::this_thread::yield();
+            for (int i = from; i < to; i++) {
+                if (sharded) {
+                    shardedQueue.enqueueViewer(gate, crowd[i]);
+                } else {
+                    std::lock_guard<std::mutex> guard(lock);
+                    lockedQueue.enqueueViewer(crowd[i]);
+                }
+            }
+        }));
+    }
+    while (ready.load() < producers) std::this_thread::yield();
+
+    Clock::time_point start = Clock::now();
+    go.store(true);
+    std::thread admission([&] {
+        // Viewers are reused across runs, so admitted ones are not deleted
+        for (int admitted = 0; admitted < total;) {
+            Viewer* v;
+            if (sharded) {
+                v = shardedQueue.dequeueViewer();
+            } else {
+                std::lock_guard<std::mutex> guard(lock);
+                v = lockedQueue.dequeueViewer();
+            }
+            if (v) {
+                admitted++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    for (size_t i = 0; i < gates.size(); i++) gates[i].join();
+    double enqueueMs = millisecondsSince(start);
+    admission.join();
+    double totalMs = millisecondsSince(start);
+
+    std::cout << std::left << std::setw(16) << (sharded ? "sharded gates" : "one mutex")
+              << std::right << std::setw(10) << producers << std::setw(10) << total
+              << std::fixed << std::setprecision(1)
+              << std::setw(12) << enqueueMs
+              << std::setw(14) << std::setprecision(0) << total / (enqueueMs / 1000.0)
+              << std::setw(12) << std::setprecision(1) << totalMs << "\n";
+}
+
+// Random gate counts and loads against ConcurrentSpectatorQueue, with the
+// admission thread dequeuing one by one and in waves while gates enqueue.
+// Checks that every viewer is admitted exactly once, that each gate's
+// viewers of one tier leave in the order that gate enqueued them, and that
+// once every gate has finished the rest leave in priority order.
+static bool runStress(int rounds) {
+    std::mt19937 rng(2025);
+    for (int round = 0; round < rounds; round++) {
+        int producers = 1 + round % 32;
+        QueueMode mode = round % 2 ? QueueMode::Buckets : QueueMode::Heap;
+        std::vector<int> counts(producers);
+        int total = 0;
+        for (int p = 0; p < producers; p++) {
+            counts[p] = static_cast<int>(rng() % 20000);
+            total += counts[p];
+        }
+        std::vector<Viewer*> crowd;
+        for (int p = 0; p < producers; p++) {
+            for (int i = 0; i < counts[p]; i++) {
+                Viewer* v = new Viewer;
+                v->id = std::to_string(crowd.size());
+                v->name = std::to_string(p);           // Gate
+                v->priority = 1 + static_cast<int>(rng() % 3);
+                v->arrivalOrder = i;                    // Order within the gate
+                crowd.push_back(v);
+            }
+        }
+        // Remember what the queue will overwrite
+        std::vector<int> gateOrder(crowd.size());
+        for (size_t i = 0; i < crowd.size(); i++) gateOrder[i] = crowd[i]->arrivalOrder;
+
+        ConcurrentSpectatorQueue queue("", LogDurability::None, mode);
+        std::atomic<int> finishedGates(0);
+        std::vector<std::thread> gates;
+        int offset = 0;
+        for (int p = 0; p < producers; p++) {
+            gates.push_back(std::thread([&, p, offset] {
+                int gate = queue.openGate();
+                for (int i = 0; i < counts[p]; i++) queue.enqueueViewer(gate, crowd[offset + i]);
+                finishedGates++;
+            }));
+            offset += counts[p];
+        }
+
+        std::vector<char> seen(total, 0);
+        std::vector<int> lastInGate(producers * PRIORITY_TIERS, -1);
+        int lastPriority = 0;
+        bool ok = true;
+        std::vector<Viewer*> wave(512);
+        for (int admitted = 0; admitted < total && ok;) {
+            bool settled = finishedGates.load() == producers;
+            int got;
+            if (rng() % 4 == 0) {
+                got = queue.admitBatch(1 + static_cast<int>(rng() % wave.size()), &wave[0]);
+            } else {
+                wave[0] = queue.dequeueViewer();
+                got = wave[0] ? 1 : 0;
+            }
+            if (got == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (int i = 0; i < got; i++) {
+                Viewer* v = wave[i];
+                int index = std::atoi(v->id.c_str());
+                int slot = std::atoi(v->name.c_str()) * PRIORITY_TIERS + v->priority - 1;
+                if (seen[index]) ok = false;
+                seen[index] = 1;
+                if (gateOrder[index] <= lastInGate[slot]) ok = false;
+                lastInGate[slot] = gateOrder[index];
+                if (settled && v->priority < lastPriority) ok = false;
+                lastPriority = settled ? v->priority : 0;
+            }
+            admitted += got;
+        }
+        for (size_t i = 0; i < gates.size(); i++) gates[i].join();
+        for (size_t i = 0; i < crowd.size(); i++) delete crowd[i];
+        if (!ok || !queue.isEmpty()) {
+            std::cout << "Stress round " << round << " FAILED (" << producers << " gates, " << total << " viewers)\n";
+            return false;
+        }
+    }
+    std::cout << "Stress test passed: " << rounds << " rounds, 1-32 gates\n";
+    return true;
+}
+
+static const char* BENCH_VIEWERS = "spectator_bench_viewers.csv";
+
+// The row-at-a-time loader loadViewers replaced: getline, split, new Viewer
+// and enqueueViewer (one O(log n) sift) per row
+static void loadViewersPerRow(SpectatorQueue& queue, const std::string& filename) {
+    std::ifstream file(filename);
+    std::string line;
+    std::getline(file, line);
+    int arrival = 0;
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        std::stringstream ss(line);
+        std::string fields[3];
+        for (int i = 0; i < 3; i++) std::getline(ss, fields[i], ',');
+        Viewer* v = new Viewer;
+        v->id = fields[0];
+        v->name = fields[1];
+        v->priority = std::stoi(fields[2]);
+        v->arrivalOrder = ++arrival;
+        queue.enqueueViewer(v);
+    }
+}
+
+static void writeViewersCsv(int rows) {
+    std::ofstream csv(BENCH_VIEWERS);
+    csv << "ViewerID,ViewerName,Priority\n";
+    for (int i = 0; i < rows; i++) {
+        Viewer* v = makeViewer(i);
+        csv << v->id << "," << v->name << "," << v->priority << "\n";
+        delete v;
+    }
+}
+
+// Loads rows viewers from a generated viewers.csv each way and checks the
+// first admissions agree
+static void runLoad(int rows) {
+    writeViewersCsv(rows);
+    const int CHECKED = 1000;
+    std::vector<std::string> expected;
+    for (int way = 0; way < 3; way++) {
+        SpectatorQueue queue("", LogDurability::None, way == 2 ? QueueMode::Buckets : QueueMode::Heap);
+        Clock::time_point start = Clock::now();
+        if (way == 0) {
+            loadViewersPerRow(queue, BENCH_VIEWERS);
+        } else {
+            queue.loadViewers(BENCH_VIEWERS);
+        }
+        double ms = millisecondsSince(start);
+
+        bool agree = true;
+        for (int i = 0; i < CHECKED && !queue.isEmpty(); i++) {
+            Viewer* v = queue.dequeueViewer();
+            if (way == 0) {
+                expected.push_back(v->id);
+            } else if (v->id != expected[i]) {
+                agree = false;
+            }
+            queue.releaseViewer(v);
+        }
+        static const char* NAMES[] = {"per-row enqueue", "bulk + Floyd heapify", "bulk into buckets"};
+        std::cout << std::left << std::setw(24) << NAMES[way] << std::right << std::setw(10) << rows
+                  << std::fixed << std::setprecision(1) << std::setw(12) << ms
+                  << std::setw(10) << (agree ? "yes" : "NO") << "\n";
+    }
+    std::remove(BENCH_VIEWERS);
+}
+
+static const char* BENCH_JOURNAL = "spectator_bench_journal";
+static const char* BENCH_CRASHED = "spectator_bench_crashed";
+
+static void copyFile(const std::string& from, const std::string& to) {
+    std::ifstream in(from, std::ios::binary);
+    std::ofstream out(to, std::ios::binary);
+    if (in.is_open()) out << in.rdbuf();
+}
+
+static void removeJournal(const std::string& base) {
+    std::remove((base + ".snapshot").c_str());
+    std::remove((base + ".snapshot.tmp").c_str());
+    std::remove((base + ".oplog").c_str());
+}
+
+// Journals a queue of rows viewers through a mix of enqueues, admissions,
+// priority changes and removals, copies its files as a crash would leave
+// them (with a half-written last record), and recovers a second queue from
+// the copy. Same: both queues then admit identical viewers in identical order.
+static void runJournal(QueueMode mode, int rows) {
+    writeViewersCsv(rows);
+    removeJournal(BENCH_JOURNAL);
+    removeJournal(BENCH_CRASHED);
+
+    SpectatorQueue live("", LogDurability::None, mode);
+    live.openJournal(BENCH_JOURNAL, LogDurability::None);
+    live.loadViewers(BENCH_VIEWERS);
+    Clock::time_point start = Clock::now();
+    live.snapshotJournal();
+    double snapshotMs = millisecondsSince(start);
+
+    int operations = rows / 5;
+    start = Clock::now();
+    for (int i = 0; i < operations; i++) {
+        switch (i % 4) {
+            case 0: {
+                Viewer* v = makeViewer(rows + i);
+                v->arrivalOrder = rows + i;
+                live.enqueueViewer(v);
+                break;
+            }
+            case 1:
+                live.releaseViewer(live.dequeueViewer());
+                break;
+            case 2:
+                live.changePriority(live.findViewer("V" + std::to_string(i * 7 % rows)), 1 + i % 3);
+                break;
+            case 3:
+                live.releaseViewer(live.removeViewer(live.findViewer("V" + std::to_string(i * 13 % rows))));
+                break;
+        }
+    }
+    double operationMs = millisecondsSince(start);
+
+    live.flushJournal();
+    copyFile(std::string(BENCH_JOURNAL) + ".snapshot", std::string(BENCH_CRASHED) + ".snapshot");
+    copyFile(std::string(BENCH_JOURNAL) + ".oplog", std::string(BENCH_CRASHED) + ".oplog");
+    {
+        std::ofstream torn(std::string(BENCH_CRASHED) + ".oplog", std::ios::binary | std::ios::app);
+        torn << "E,V-1,Torn Wri";
+    }
+
+    SpectatorQueue recovered("", LogDurability::None, mode);
+    start = Clock::now();
+    bool restored = recovered.openJournal(BENCH_CRASHED, LogDurability::None);
+    double recoverMs = millisecondsSince(start);
+
+    bool same = restored && recovered.size() == live.size();
+    while (same && !live.isEmpty()) {
+        Viewer* a = live.dequeueViewer();
+        Viewer* b = recovered.dequeueViewer();
+        same = a->id == b->id && a->name == b->name && a->priority == b->priority &&
+               a->arrivalOrder == b->arrivalOrder;
+        live.releaseViewer(a);
+        recovered.releaseViewer(b);
+    }
+    std::cout << std::left << std::setw(12) << (mode == QueueMode::Heap ? "heap" : "buckets")
+              << std::right << std::setw(10) << rows << std::setw(12) << operations
+              << std::fixed << std::setprecision(1) << std::setw(12) << snapshotMs
+              << std::setw(12) << operationMs << std::setw(12) << recoverMs
+              << std::setw(8) << (same ? "yes" : "NO") << "\n";
+
+    live.discardJournal();
+    recovered.discardJournal();
+    std::remove(BENCH_VIEWERS);
+}
+
+static const char* BENCH_GUARD_LOG = "spectator_bench_admitted.csv";
+
+static std::string admittedID(int i) { return "A" + std::to_string(i); }
+
+// Membership of ids.size() admitted IDs: build, then look up every ID
+// (hits) and as many IDs that were never added (misses)
+template <typename Set>
+static void timeMembership(const std::string& label, Set& set, const std::vector<std::string>& ids,
+                           const std::vector<std::string>& absent, const std::string& memory) {
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < ids.size(); i++) set.insert(ids[i]);
+    double buildMs = millisecondsSince(start);
+    long long found = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < ids.size(); i++) found += set.count(ids[i]);
+    double hitNs = millisecondsSince(start) * 1e6 / ids.size();
+    start = Clock::now();
+    for (size_t i = 0; i < absent.size(); i++) found += set.count(absent[i]);
+    double missNs = millisecondsSince(start) * 1e6 / absent.size();
+    std::cout << std::left << std::setw(24) << label << std::right << std::setw(10) << ids.size()
+              << std::fixed << std::setprecision(1) << std::setw(12) << buildMs << std::setw(10) << hitNs
+              << std::setw(10) << missNs << std::setw(10) << memory
+              << (found == static_cast<long long>(ids.size()) ? "" : "  (false positives counted)") << "\n";
+}
+
+// IdSet with the std::unordered_set interface timeMembership uses
+struct CountingIdSet {
+    IdSet set;
+    explicit CountingIdSet(bool bloom) : set(bloom) {}
+    void insert(const std::string& id) { set.insert(id); }
+    int count(const std::string& id) const { return set.contains(id) ? 1 : 0; }
+};
+
+static void runMembership(int idCount) {
+    std::vector<std::string> ids(idCount);
+    std::vector<std::string> absent(idCount);
+    for (int i = 0; i < idCount; i++) {
+        ids[i] = admittedID(i);
+        absent[i] = "V" + std::to_string(i);
+    }
+    {
+        std::unordered_set<std::string> set;
+        timeMembership("std::unordered_set", set, ids, absent, "-");
+    }
+    for (int bloom = 0; bloom < 2; bloom++) {
+        CountingIdSet set(bloom == 1);
+        // Memory is known only once built; build a twin to report it up front
+        IdSet twin(bloom == 1);
+        for (int i = 0; i < idCount; i++) twin.insert(ids[i]);
+        char megabytes[32];
+        std::snprintf(megabytes, sizeof(megabytes), "%.1f", twin.memoryBytes() / 1048576.0);
+        timeMembership(bloom ? "IdSet + Bloom filter" : "IdSet", set, ids, absent, megabytes);
+    }
+}
+
+// A restart into a line whose admission log already lists admitted IDs:
+// restoring the journal rebuilds the set from the log, then viewers arrive,
+// the second half carrying admitted IDs, and everyone accepted is admitted
+static void runGuard(DuplicateGuard guard, int admitted) {
+    {
+        std::ofstream log(BENCH_GUARD_LOG);
+        log << "ViewerID,ViewerName,Priority,AdmitTime,ChannelID\n";
+        for (int i = 0; i < admitted; i++) {
+            log << admittedID(i) << ",Viewer " << i << ",3,2025-06-15T00:00,ChannelX\n";
+        }
+        // An empty line whose admissions start at the top of the log
+        removeJournal(BENCH_JOURNAL);
+        std::ofstream snapshot(std::string(BENCH_JOURNAL) + ".snapshot");
+        snapshot << "SNAPSHOT,1,0,0,0\n";
+    }
+    int arrivals = admitted;
+    Viewer** crowd = makeViewers(arrivals);
+    for (int i = arrivals / 2; i < arrivals; i++) crowd[i]->id = admittedID(i);
+
+    Clock::time_point start = Clock::now();
+    SpectatorQueue queue(BENCH_GUARD_LOG, LogDurability::None, QueueMode::Heap, guard);
+    queue.openJournal(BENCH_JOURNAL, LogDurability::None);
+    double startupMs = millisecondsSince(start);
+
+    int rejected = 0;
+    start = Clock::now();
+    for (int i = 0; i < arrivals; i++) {
+        if (queue.enqueueViewer(crowd[i]) == NO_HANDLE) {
+            delete crowd[i];
+            rejected++;
+        }
+    }
+    double enqueueMs = millisecondsSince(start);
+
+    start = Clock::now();
+    while (!queue.isEmpty()) queue.releaseViewer(queue.dequeueViewer());
+    double admitMs = millisecondsSince(start);
+    delete[] crowd;
+
+    static const char* NAMES[] = {"off", "exact", "Bloom-prefiltered"};
+    std::cout << std::left << std::setw(20) << NAMES[static_cast<int>(guard)] << std::right
+              << std::setw(10) << arrivals << std::fixed << std::setprecision(1)
+              << std::setw(12) << startupMs << std::setw(12) << enqueueMs << std::setw(10) << rejected
+              << std::setw(12) << admitMs << "\n";
+    queue.discardJournal();
+    std::remove(BENCH_GUARD_LOG);
+}
+
+// Fake admit clock for the slot benchmark
+static long long benchMinute = 0;
+static long long benchClock() { return benchMinute; }
+
+static const char* BENCH_SLOTS = "spectator_bench_slots.csv";
+
+// Admits slotCount * seatsPerSlot viewers against slotCount one-minute slots,
+// timing each dequeueViewer. With advancing, the clock moves one minute per
+// full slot; otherwise it stays at the first slot and every later viewer
+// spills forward past the full slots. slotCount 0 runs with no slots loaded.
+static void runSlots(int slotCount, int seatsPerSlot, bool advancing) {
+    long long firstMinute;
+    parseSlotTime("2025-06-15T00:00", firstMinute);
+    int viewers = (slotCount > 0 ? slotCount : 10000) * seatsPerSlot;
+
+    std::ofstream csv(BENCH_SLOTS);
+    csv << "SlotID,TimeStart,TimeEnd,ChannelID,Capacity\n";
+    for (int i = 0; i < slotCount; i++) {
+        csv << "S" << i << "," << formatSlotTime(firstMinute + i) << "," << formatSlotTime(firstMinute + i + 1)
+            << ",Channel" << (i % 5 + 1) << "," << seatsPerSlot << "\n";
+    }
+    csv.close();
+
+    SpectatorQueue queue("", LogDurability::None);
+    queue.loadSlots(BENCH_SLOTS);
+    queue.setAdmitClock(benchClock);
+    for (int i = 0; i < viewers; i++) queue.enqueueViewer(makeViewer(i));
+
+    std::vector<double> latency(viewers);
+    benchMinute = firstMinute;
+    for (int i = 0; i < viewers; i++) {
+        if (advancing) benchMinute = firstMinute + i / seatsPerSlot;
+        Clock::time_point start = Clock::now();
+        Viewer* v = queue.dequeueViewer();
+        latency[i] = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        delete v;
+    }
+    double sum = 0;
+    for (int i = 0; i < viewers; i++) sum += latency[i];
+    std::sort(latency.begin(), latency.end());
+
+    std::cout << std::left << std::setw(24)
+              << (slotCount == 0 ? "no slots" : advancing ? "clock advancing" : "clock frozen (spill)")
+              << std::right << std::setw(10) << slotCount << std::setw(10) << viewers
+              << std::fixed << std::setprecision(0)
+              << std::setw(10) << sum / viewers << std::setw(10) << latency[viewers / 2]
+              << std::setw(10) << latency[viewers * 99 / 100] << std::setw(12) << latency[viewers - 1] << "\n";
+    std::remove(BENCH_SLOTS);
+}
+
+// Regression checks (--check): each compares SpectatorQueue and its parts
+// against a brute-force model or against itself another way, on seeded
+// random workloads, and returns "" or what went wrong
+
+static const char* CHECK_VIEWERS = "spectator_check_viewers.csv";
+static const char* CHECK_LOG = "spectator_check_log.csv";
+static const char* CHECK_LOG_B = "spectator_check_log_b.csv";
+static const char* CHECK_SLOTS = "spectator_check_slots.csv";
+static const char* CHECK_JOURNAL = "spectator_check_journal";
+static const char* CHECK_CRASHED = "spectator_check_crashed";
+
+static Viewer* checkViewer(const std::string& id, const std::string& name, int priority, int arrival) {
+    Viewer* v = new Viewer;
+    v->id = id;
+    v->name = name;
+    v->priority = priority;
+    v->arrivalOrder = arrival;
+    return v;
+}
+
+static std::string readWhole(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    std::ostringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+// Admits every waiting viewer; one "priority,arrival,id,name" per
+// admission, with the numbers padded so the rows sort in heap order
+static std::vector<std::string> drainQueue(SpectatorQueue& queue) {
+    std::vector<std::string> order;
+    char key[32];
+    while (!queue.isEmpty()) {
+        Viewer* v = queue.dequeueViewer();
+        std::snprintf(key, sizeof(key), "%d,%010d,", v->priority, v->arrivalOrder);
+        order.push_back(key + v->id + "," + v->name);
+        queue.releaseViewer(v);
+    }
+    return order;
+}
+
+// admitBatch admits the same viewers in the same order as repeated
+// dequeueViewer, and logs them identically
+static std::string checkBatches() {
+    std::mt19937 rng(42);
+    std::remove(CHECK_LOG);
+    std::remove(CHECK_LOG_B);
+    std::string failure;
+    {
+        SpectatorQueue batched(CHECK_LOG, LogDurability::Batched, QueueMode::Heap, DuplicateGuard::Off);
+        SpectatorQueue single(CHECK_LOG_B, LogDurability::PerRecord, QueueMode::Heap, DuplicateGuard::Off);
+        batched.setAdmitClock(benchClock);
+        single.setAdmitClock(benchClock);
+        std::vector<Viewer*> wave;
+        int next = 0;
+        for (int round = 0; round < 200 && failure.empty(); round++) {
+            int arrivals = static_cast<int>(rng() % 2000);
+            for (int i = 0; i < arrivals; i++, next++) {
+                int priority = 1 + static_cast<int>(rng() % 3);
+                std::string id = "V" + std::to_string(next);
+                batched.enqueueViewer(checkViewer(id, "N", priority, next));
+                single.enqueueViewer(checkViewer(id, "N", priority, next));
+            }
+            // Small waves take the pop path, large ones the partial sort
+            int n = static_cast<int>(rng() % 2 ? rng() % 50 : rng() % 3000);
+            wave.resize(n + 1);
+            int admitted = batched.admitBatch(n, &wave[0]);
+            for (int i = 0; i < admitted; i++) {
+                Viewer* v = single.dequeueViewer();
+                if (!v || v->id != wave[i]->id) failure = "order differs in round " + std::to_string(round);
+                single.releaseViewer(v);
+                batched.releaseViewer(wave[i]);
+            }
+            if (batched.size() != single.size()) failure = "sizes differ in round " + std::to_string(round);
+        }
+        batched.flushAdmissionLog();
+    }
+    if (failure.empty() && readWhole(CHECK_LOG) != readWhole(CHECK_LOG_B)) failure = "admission logs differ";
+    std::remove(CHECK_LOG);
+    std::remove(CHECK_LOG_B);
+    return failure;
+}
+
+// Bucket mode admits in the same order as heap mode when priorities are
+// 1..3 and arrivals only grow
+static std::string checkBuckets() {
+    std::mt19937 rng(43);
+    SpectatorQueue buckets("", LogDurability::None, QueueMode::Buckets, DuplicateGuard::Off);
+    SpectatorQueue heap("", LogDurability::None, QueueMode::Heap, DuplicateGuard::Off);
+    std::vector<Viewer*> wave;
+    int next = 0;
+    for (int round = 0; round < 300; round++) {
+        int arrivals = static_cast<int>(rng() % 2000);
+        for (int i = 0; i < arrivals; i++, next++) {
+            int priority = 1 + static_cast<int>(rng() % 3);
+            std::string id = "V" + std::to_string(next);
+            buckets.enqueueViewer(checkViewer(id, "N", priority, next));
+            heap.enqueueViewer(checkViewer(id, "N", priority, next));
+        }
+        int n = static_cast<int>(rng() % 3000);
+        wave.resize(n + 1);
+        int admitted = 0;
+        if (rng() % 2) {
+            admitted = buckets.admitBatch(n, &wave[0]);
+        } else {
+            while (admitted < n && !buckets.isEmpty()) wave[admitted++] = buckets.dequeueViewer();
+        }
+        for (int i = 0; i < admitted; i++) {
+            Viewer* v = heap.dequeueViewer();
+            bool same = v && v->id == wave[i]->id;
+            heap.releaseViewer(v);
+            buckets.releaseViewer(wave[i]);
+            if (!same) return "order differs in round " + std::to_string(round);
+        }
+        if (buckets.size() != heap.size()) return "sizes differ in round " + std::to_string(round);
+        if (round == 150) {
+            buckets.clearAll();
+            heap.clearAll();
+        }
+    }
+    return "";
+}
+
+// Handles, changePriority, removeViewer and admitBatch against an ordered
+// set of (tier or priority, arrival or enqueue sequence, id)
+static std::string checkHandles(QueueMode mode, unsigned seed) {
+    typedef std::tuple<long long, long long, std::string> Key;
+    std::mt19937 rng(seed);
+    SpectatorQueue queue("", LogDurability::None, mode, DuplicateGuard::Off);
+    std::set<Key> model;
+    std::map<std::string, Key> byID;
+    long long sequence = 0;
+    int next = 0;
+    // Bucket mode clamps priorities to a tier and orders a tier by enqueue,
+    // including the re-enqueue of a priority change
+    auto tier = [](int priority) { return priority < 1 ? 1 : priority > PRIORITY_TIERS ? PRIORITY_TIERS : priority; };
+    auto keyOf = [&](int priority, long long arrival, const std::string& id) {
+        return mode == QueueMode::Heap ? Key(priority, arrival, id) : Key(tier(priority), sequence++, id);
+    };
+    std::vector<Viewer*> wave;
+    for (int step = 0; step < 200000; step++) {
+        int op = static_cast<int>(rng() % 10);
+        std::string where = " at step " + std::to_string(step);
+        if (op < 4) {
+            Viewer* v = checkViewer("V" + std::to_string(next), "N", static_cast<int>(rng() % 5), next);
+            next++;
+            ViewerHandle h = queue.enqueueViewer(v);
+            if (queue.findViewer(v->id) != h) return "findViewer misses a new viewer" + where;
+            Key key = keyOf(v->priority, v->arrivalOrder, v->id);
+            model.insert(key);
+            byID[v->id] = key;
+        } else if (op < 6) {
+            Viewer* v = queue.dequeueViewer();
+            if (model.empty()) {
+                if (v) return "dequeue from an empty queue" + where;
+                continue;
+            }
+            Key key = *model.begin();
+            model.erase(model.begin());
+            bool same = v && v->id == std::get<2>(key);
+            if (v) byID.erase(v->id);
+            if (same && queue.findViewer(v->id) != NO_HANDLE) return "findViewer finds an admitted viewer" + where;
+            queue.releaseViewer(v);
+            if (!same) return "dequeue order" + where;
+        } else if (op < 8 && !byID.empty()) {
+            std::map<std::string, Key>::iterator it = byID.begin();
+            std::advance(it, rng() % std::min<size_t>(byID.size(), 50));
+            ViewerHandle h = queue.findViewer(it->first);
+            if (h == NO_HANDLE) return "findViewer misses a waiting viewer" + where;
+            int priority = 1 + static_cast<int>(rng() % 3);
+            Key old = it->second;
+            if (mode == QueueMode::Heap || tier(priority) != std::get<0>(old)) {
+                model.erase(old);
+                it->second = keyOf(priority, std::get<1>(old), it->first);
+                model.insert(it->second);
+            }
+            queue.changePriority(h, priority);
+        } else if (op < 9 && !byID.empty()) {
+            std::map<std::string, Key>::iterator it = byID.begin();
+            std::advance(it, rng() % std::min<size_t>(byID.size(), 50));
+            ViewerHandle h = queue.findViewer(it->first);
+            Viewer* v = queue.removeViewer(h);
+            bool same = v && v->id == it->first;
+            queue.releaseViewer(v);
+            if (!same) return "removeViewer" + where;
+            model.erase(it->second);
+            byID.erase(it);
+            if (queue.removeViewer(h) != nullptr) return "stale handle removed twice" + where;
+        } else {
+            int n = static_cast<int>(rng() % 300);
+            wave.resize(n + 1);
+            int admitted = queue.admitBatch(n, &wave[0]);
+            for (int i = 0; i < admitted; i++) {
+                bool same = wave[i]->id == std::get<2>(*model.begin());
+                model.erase(model.begin());
+                byID.erase(wave[i]->id);
+                queue.releaseViewer(wave[i]);
+                if (!same) return "admitBatch order" + where;
+            }
+        }
+        if (queue.size() != static_cast<int>(model.size())) return "size" + where;
+        if (step == 100000) {
+            queue.clearAll();
+            model.clear();
+            byID.clear();
+        }
+    }
+    return "";
+}
+
+// Stream-slot assignment, read back from the admission log, against a scan
+// in start order: the first running slot with room, else, when slots are
+// running but full, the first later slot with room
+static std::string checkSlots() {
+    struct ModelSlot {
+        long long start;
+        long long end;
+        int capacity;
+        int used;
+        std::string channel;
+    };
+    std::mt19937 rng(46);
+    long long first;
+    parseSlotTime("2025-06-15T08:00", first);
+    for (int round = 0; round < 100; round++) {
+        int slotCount = 1 + static_cast<int>(rng() % 60);
+        std::vector<ModelSlot> model;
+        {
+            std::ofstream csv(CHECK_SLOTS);
+            csv << "SlotID,TimeStart,TimeEnd,ChannelID,Capacity\n";
+            for (int i = 0; i < slotCount; i++) {
+                ModelSlot slot;
+                slot.start = first + rng() % 300;
+                slot.end = slot.start + 1 + rng() % (round % 2 ? 200 : 40);
+                slot.capacity = 1 + static_cast<int>(rng() % 4);
+                slot.used = 0;
+                slot.channel = "C" + std::to_string(i);
+                csv << "S" << i << "," << formatSlotTime(slot.start) << "," << formatSlotTime(slot.end) << ","
+                    << slot.channel << "," << slot.capacity << "\n";
+                model.push_back(slot);
+            }
+        }
+        std::stable_sort(model.begin(), model.end(),
+                         [](const ModelSlot& a, const ModelSlot& b) { return a.start < b.start; });
+
+        std::remove(CHECK_LOG);
+        std::vector<std::string> expected;
+        {
+            SpectatorQueue queue(CHECK_LOG, LogDurability::None, QueueMode::Heap, DuplicateGuard::Off);
+            queue.loadSlots(CHECK_SLOTS);
+            queue.setAdmitClock(benchClock);
+            for (int k = 0; k < 200; k++) {
+                benchMinute = first - 10 + rng() % 400;
+                std::string channel = "Unassigned";
+                bool running = false;
+                int pick = -1;
+                for (size_t i = 0; i < model.size(); i++) {
+                    if (model[i].start <= benchMinute && model[i].end > benchMinute) {
+                        running = true;
+                        if (model[i].used < model[i].capacity) {
+                            pick = static_cast<int>(i);
+                            break;
+                        }
+                    }
+                }
+                for (size_t i = 0; i < model.size() && pick < 0 && running; i++) {
+                    if (model[i].start > benchMinute && model[i].used < model[i].capacity) pick = static_cast<int>(i);
+                }
+                if (pick >= 0) {
+                    model[pick].used++;
+                    channel = model[pick].channel;
+                }
+                expected.push_back(channel);
+                queue.enqueueViewer(checkViewer("V" + std::to_string(k), "N", 1, k));
+                queue.releaseViewer(queue.dequeueViewer());
+            }
+        }
+        std::ifstream log(CHECK_LOG);
+        std::string line;
+        std::getline(log, line);
+        for (size_t k = 0; k < expected.size(); k++) {
+            if (!std::getline(log, line) || line.substr(line.rfind(',') + 1) != expected[k]) {
+                return "admission " + std::to_string(k) + " of round " + std::to_string(round) + " went to " +
+                       line.substr(line.rfind(',') + 1) + ", expected " + expected[k];
+            }
+        }
+    }
+    std::remove(CHECK_LOG);
+    std::remove(CHECK_SLOTS);
+
+    const char* times[] = {"2025-06-15T08:00", "2024-02-29T23:59", "1969-12-31T23:59", "2000-01-01T00:00"};
+    for (int i = 0; i < 4; i++) {
+        long long minute;
+        if (!parseSlotTime(times[i], minute) || formatSlotTime(minute) != times[i]) {
+            return std::string("slot time ") + times[i] + " does not round-trip";
+        }
+    }
+    return "";
+}
+
+// What a restart from base's files restores, drained in admission order.
+// The files are deleted first, so draining is not journalled.
+// Heap mode admits viewers with equal keys in no set order, so its rows
+// are sorted to compare lines.
+static std::vector<std::string> recoverLine(const std::string& base, QueueMode mode) {
+    SpectatorQueue queue("", LogDurability::None, mode, DuplicateGuard::Off);
+    queue.openJournal(base, LogDurability::None);
+    queue.discardJournal();
+    std::vector<std::string> order = drainQueue(queue);
+    if (mode == QueueMode::Heap) std::sort(order.begin(), order.end());
+    return order;
+}
+
+// Fills CHECK_CRASHED as a crash would leave it: CHECK_JOURNAL's snapshot
+// saved with the suffix snapshotSuffix, the log copied from oplogFrom and,
+// with torn, half a record after it
+static void crashImage(const std::string& snapshotSuffix, const std::string& oplogFrom, bool torn) {
+    removeJournal(CHECK_CRASHED);
+    copyFile(std::string(CHECK_JOURNAL) + ".snapshot", std::string(CHECK_CRASHED) + snapshotSuffix);
+    copyFile(oplogFrom, std::string(CHECK_CRASHED) + ".oplog");
+    if (torn) {
+        std::ofstream tail(std::string(CHECK_CRASHED) + ".oplog", std::ios::binary | std::ios::app);
+        tail << "P,V1,3";
+    }
+}
+
+// Restarts from copies of a live queue's journal. At random points a copy,
+// with or without a torn last record, must restore as many viewers as are
+// waiting. At the end, after D, R and P records on top of a snapshot, each
+// of these must restore exactly the live line: the copy as is; the new
+// snapshot with the previous generation's log (a crash between the rename
+// and starting the new log); and that snapshot left as .snapshot.tmp
+static std::string checkJournal(QueueMode mode, unsigned seed, int operations) {
+    std::mt19937 rng(seed);
+    std::string liveLog = std::string(CHECK_JOURNAL) + ".oplog";
+    std::string oldLog = std::string(CHECK_JOURNAL) + ".old";
+    removeJournal(CHECK_JOURNAL);
+    {
+        std::ofstream csv(CHECK_VIEWERS);
+        csv << "ViewerID,ViewerName,Priority\n";
+        int rows = static_cast<int>(rng() % 50);
+        for (int i = 0; i < rows; i++) csv << "V" << rng() % 30 << ",N " << i << "," << 1 + rng() % 3 << "\n";
+    }
+    SpectatorQueue live("", LogDurability::None, mode, DuplicateGuard::Off);
+    if (live.openJournal(CHECK_JOURNAL, LogDurability::None)) return "a new journal restored a line";
+    live.loadViewers(CHECK_VIEWERS);
+    std::string failure;
+    int next = 1000;
+    Viewer* wave[8];
+    for (int i = 0; i < operations && failure.empty(); i++) {
+        std::string id = "V" + std::to_string(rng() % 40);
+        int op = static_cast<int>(rng() % 10);
+        if (op < 3) {
+            // Some arrivals repeat an arrivalOrder, so replay must match on the ID too
+            int arrival = rng() % 4 ? next++ : 5;
+            live.enqueueViewer(checkViewer(id, "M" + std::to_string(i), 1 + static_cast<int>(rng() % 3), arrival));
+        } else if (op < 5) {
+            live.releaseViewer(live.dequeueViewer());
+        } else if (op < 6) {
+            int admitted = live.admitBatch(static_cast<int>(rng() % 8), wave);
+            for (int j = 0; j < admitted; j++) live.releaseViewer(wave[j]);
+        } else if (op < 8) {
+            live.changePriority(live.findViewer(id), 1 + static_cast<int>(rng() % 3));
+        } else if (op < 9) {
+            live.releaseViewer(live.removeViewer(live.findViewer(id)));
+        } else if (rng() % 50 == 0) {
+            live.snapshotJournal();
+        }
+        if (rng() % 97 == 0) {
+            live.flushJournal();
+            crashImage(".snapshot", liveLog, rng() % 2 == 0);
+            if (static_cast<int>(recoverLine(CHECK_CRASHED, mode).size()) != live.size()) {
+                failure = "restart after operation " + std::to_string(i) + " lost or gained viewers";
+            }
+        }
+    }
+
+    if (failure.empty()) {
+        // One of each record type on top of a fresh snapshot
+        live.snapshotJournal();
+        live.releaseViewer(live.dequeueViewer());
+        live.releaseViewer(live.removeViewer(live.findViewer("V" + std::to_string(rng() % 40))));
+        live.changePriority(live.findViewer("V" + std::to_string(rng() % 40)), 1 + static_cast<int>(rng() % 3));
+        live.enqueueViewer(checkViewer("V-late", "Late", 2, next++));
+
+        live.flushJournal();
+        crashImage(".snapshot", liveLog, true);
+        std::vector<std::string> replayed = recoverLine(CHECK_CRASHED, mode);
+        copyFile(liveLog, oldLog);
+        live.snapshotJournal();
+        crashImage(".snapshot", oldLog, false);
+        std::vector<std::string> renamed = recoverLine(CHECK_CRASHED, mode);
+        crashImage(".snapshot.tmp", oldLog, false);
+        std::vector<std::string> uninstalled = recoverLine(CHECK_CRASHED, mode);
+        std::vector<std::string> expected = drainQueue(live);
+        if (mode == QueueMode::Heap) std::sort(expected.begin(), expected.end());
+        if (replayed != expected) failure = "replaying D, R and P records gave a different line";
+        else if (renamed != expected) failure = "a new snapshot with the old log gave a different line";
+        else if (uninstalled != expected) failure = "a snapshot left as .tmp gave a different line";
+    }
+    live.discardJournal();
+    removeJournal(CHECK_CRASHED);
+    std::remove(oldLog.c_str());
+    std::remove(CHECK_VIEWERS);
+    return failure;
+}
+
+// Arrival numbers handed out after a restart come after every replayed
+// enqueue, not only after the snapshot's counter
+static std::string checkReplayedArrivals() {
+    removeJournal(CHECK_JOURNAL);
+    {
+        std::ofstream csv(CHECK_VIEWERS);
+        csv << "ViewerID,ViewerName,Priority\nV1,A,1\nV2,B,2\n";
+    }
+    {
+        SpectatorQueue live("", LogDurability::None, QueueMode::Heap, DuplicateGuard::Off);
+        live.openJournal(CHECK_JOURNAL, LogDurability::None);
+        live.loadViewers(CHECK_VIEWERS);     // Snapshot with arrival counter 2
+        live.enqueueViewer(checkViewer("V3", "C", 3, 7));
+    }
+    std::string failure;
+    {
+        std::ofstream csv(CHECK_VIEWERS);
+        csv << "ViewerID,ViewerName,Priority\nV4,D,3\n";
+    }
+    SpectatorQueue restored("", LogDurability::None, QueueMode::Heap, DuplicateGuard::Off);
+    if (!restored.openJournal(CHECK_JOURNAL, LogDurability::None)) failure = "nothing restored";
+    restored.loadViewers(CHECK_VIEWERS);
+    restored.discardJournal();
+    std::vector<std::string> order = drainQueue(restored);
+    if (failure.empty() && (order.size() != 4 || order.back() != "3,0000000008,V4,D")) {
+        failure = "a viewer loaded after the restart got " + (order.empty() ? std::string("nothing") : order.back());
+    }
+    std::remove(CHECK_VIEWERS);
+    return failure;
+}
+
+// Percentiles within one sub-bucket (1/32) above the exact sorted value
+static std::string checkWaitHistogram() {
+    std::mt19937_64 rng(49);
+    const double percents[] = {0.0, 1.0, 50.0, 90.0, 99.0, 99.9, 100.0};
+    for (int round = 0; round < 200; round++) {
+        WaitHistogram histogram;
+        std::vector<long long> values;
+        int n = 1 + static_cast<int>(rng() % 5000);
+        for (int i = 0; i < n; i++) {
+            long long value = static_cast<long long>(rng() >> (1 + rng() % 63));
+            if (round == 0 && i == 0) value = LLONG_MAX;
+            values.push_back(value);
+            histogram.record(value);
+        }
+        std::sort(values.begin(), values.end());
+        for (int p = 0; p < 7; p++) {
+            long long rank = static_cast<long long>(std::ceil(percents[p] / 100.0 * n));
+            long long exact = values[rank > 1 ? rank - 1 : 0];
+            long long reported = histogram.percentile(percents[p]);
+            if (reported < exact || static_cast<double>(reported - exact) > exact / 32.0 + 1) {
+                return "p" + std::to_string(percents[p]) + " of round " + std::to_string(round) + " is " +
+                       std::to_string(reported) + ", exact " + std::to_string(exact);
+            }
+        }
+        if (histogram.count() != n || histogram.min() != values.front() || histogram.max() != values.back()) {
+            return "count, min or max of round " + std::to_string(round);
+        }
+    }
+    return "";
+}
+
+// IdSet, with and without its Bloom filter, against std::unordered_set on
+// short IDs from a small alphabet, so lookups collide often
+static std::string checkIdSet() {
+    std::mt19937 rng(50);
+    for (int bloom = 0; bloom < 2; bloom++) {
+        IdSet set(bloom == 1);
+        std::unordered_set<std::string> model;
+        for (int i = 0; i < 300000; i++) {
+            std::string id(1 + rng() % 12, 'a');
+            for (size_t c = 0; c < id.size(); c++) id[c] = static_cast<char>('a' + rng() % 3);
+            if (rng() % 2) {
+                if (set.insert(id) != model.insert(id).second) return "insert of " + id + " disagrees";
+            } else if (set.contains(id) != (model.count(id) > 0)) {
+                return "contains of " + id + " disagrees";
+            }
+            if (i == 150000) {
+                set.clear();
+                model.clear();
+            }
+        }
+        if (set.size() != static_cast<int>(model.size())) return "size disagrees";
+    }
+    return "";
+}
+
+// The duplicate guard against a model of waiting and admitted IDs, through
+// restarts that sometimes land in the window where an admission is in the
+// admission log but not the journal
+static std::string checkGuard(DuplicateGuard guard) {
+    std::mt19937 rng(guard == DuplicateGuard::Exact ? 501 : 502);
+    for (int round = 0; round < 30; round++) {
+        std::remove(CHECK_LOG);
+        removeJournal(CHECK_JOURNAL);
+        std::set<std::string> admitted;
+        std::set<std::string> waiting;
+        bool journalled = false;    // Every journal record follows an accepted enqueue
+        int pool = 20 + static_cast<int>(rng() % 2000);
+        std::string failure;
+        Viewer* wave[16];
+        // One run of the queue per pass, until the next restart
+        for (int step = 0, run = 0; step < 3000 && failure.empty(); run++) {
+            SpectatorQueue queue(CHECK_LOG, LogDurability::Batched,
+                                 run > 0 && rng() % 2 ? QueueMode::Buckets : QueueMode::Heap, guard);
+            bool restored = queue.openJournal(CHECK_JOURNAL, LogDurability::None);
+            if (restored != journalled) {
+                failure = restored ? "a new line restored" : "restart restored nothing";
+            }
+            for (std::set<std::string>::iterator it = admitted.begin(); it != admitted.end(); ++it) {
+                if (!queue.wasAdmitted(*it)) failure = "restart forgot that " + *it + " was admitted";
+            }
+            for (std::set<std::string>::iterator it = waiting.begin(); it != waiting.end(); ++it) {
+                if (queue.findViewer(*it) == NO_HANDLE) failure = "restart lost " + *it;
+            }
+            bool restart = false;
+            for (; step < 3000 && failure.empty() && !restart; step++) {
+                std::string id = "V" + std::to_string(rng() % pool);
+                int op = static_cast<int>(rng() % 12);
+                if (op < 5) {
+                    Viewer* v = checkViewer(id, "N", 1 + static_cast<int>(rng() % 3), step);
+                    bool duplicate = admitted.count(id) || waiting.count(id);
+                    bool turnedAway = queue.enqueueViewer(v) == NO_HANDLE;
+                    if (turnedAway != duplicate) failure = id + (duplicate ? " was let in twice" : " was turned away");
+                    if (turnedAway) {
+                        delete v;
+                    } else {
+                        waiting.insert(id);
+                        journalled = true;
+                    }
+                } else if (op < 8) {
+                    int admittedNow = queue.admitBatch(static_cast<int>(rng() % 16), wave);
+                    for (int i = 0; i < admittedNow; i++) {
+                        if (!admitted.insert(wave[i]->id).second) failure = wave[i]->id + " was admitted twice";
+                        waiting.erase(wave[i]->id);
+                        queue.releaseViewer(wave[i]);
+                    }
+                } else if (op < 9) {
+                    Viewer* v = queue.removeViewer(queue.findViewer(id));
+                    if (v) waiting.erase(id);
+                    queue.releaseViewer(v);
+                } else if (op < 10) {
+                    queue.changePriority(queue.findViewer(id), 1 + static_cast<int>(rng() % 3));
+                } else {
+                    restart = rng() % 40 == 0;
+                }
+                if (queue.size() != static_cast<int>(waiting.size())) failure = "size after step " + std::to_string(step);
+            }
+            if (!restart || !failure.empty()) {
+                queue.discardJournal();
+                continue;
+            }
+            queue.flushAdmissionLog();
+            if (!waiting.empty() && rng() % 2) {
+                // Admitted and logged, but the D record never reached the journal
+                std::string lost = *waiting.begin();
+                std::ofstream log(CHECK_LOG, std::ios::app);
+                log << lost << ",N,1,2025-06-15T00:00,Channel1\n";
+                waiting.erase(lost);
+                admitted.insert(lost);
+            }
+        }
+        removeJournal(CHECK_JOURNAL);
+        if (!failure.empty()) return failure + " in round " + std::to_string(round);
+    }
+    std::remove(CHECK_LOG);
+    return "";
+}
+
+// Admissions of earlier lines never turn anyone away: not when a new line
+// loads, not when it is restored, and not after End Tournament
+static std::string checkGuardLifetime(DuplicateGuard guard) {
+    const int VIEWERS = 50;
+    std::remove(CHECK_LOG);
+    removeJournal(CHECK_JOURNAL);
+    {
+        std::ofstream csv(CHECK_VIEWERS);
+        csv << "ViewerID,ViewerName,Priority\n";
+        for (int i = 0; i < VIEWERS; i++) csv << "V" << i << ",N," << 1 + i % 3 << "\n";
+        // Admitted in an earlier line
+        std::ofstream log(CHECK_LOG);
+        log << "ViewerID,ViewerName,Priority,AdmitTime,ChannelID\n";
+        for (int i = 0; i < 10; i++) log << "V" << i << ",N,1,2025-06-14T00:00,Channel1\n";
+    }
+    std::string failure;
+    for (int line = 0; line < 3 && failure.empty(); line++) {
+        std::string which = " in line " + std::to_string(line);
+        {
+            SpectatorQueue queue(CHECK_LOG, LogDurability::Batched, QueueMode::Heap, guard);
+            if (queue.openJournal(CHECK_JOURNAL, LogDurability::None)) failure = "a new line restored" + which;
+            int skipped = queue.loadViewers(CHECK_VIEWERS);
+            if (skipped != 0 || queue.size() != VIEWERS) {
+                failure = std::to_string(skipped) + " of the loaded viewers turned away" + which;
+            }
+            Viewer* wave[10];
+            int admitted = queue.admitBatch(10, wave);
+            for (int i = 0; i < admitted; i++) queue.releaseViewer(wave[i]);
+        }
+        // Restart mid-line: the line's own admissions still count
+        SpectatorQueue queue(CHECK_LOG, LogDurability::Batched, QueueMode::Heap, guard);
+        if (!queue.openJournal(CHECK_JOURNAL, LogDurability::None) || queue.size() != VIEWERS - 10) {
+            if (failure.empty()) failure = "restart restored " + std::to_string(queue.size()) + " viewers" + which;
+        }
+        if (queue.loadViewers(CHECK_VIEWERS) != VIEWERS && failure.empty()) {
+            failure = "reloading after a restart let viewers in twice" + which;
+        }
+        // End Tournament, then a new line in the same queue
+        queue.discardJournal();
+        queue.clearAll();
+        queue.openJournal(CHECK_JOURNAL, LogDurability::None);
+        if (queue.loadViewers(CHECK_VIEWERS) != 0 && failure.empty()) {
+            failure = "the next line in the same queue turned viewers away" + which;
+        }
+        queue.discardJournal();
+    }
+    std::remove(CHECK_LOG);
+    std::remove(CHECK_VIEWERS);
+    return failure;
+}
+
+static bool report(const std::string& name, const std::string& failure) {
+    std::cout << std::left << std::setw(44) << name << (failure.empty() ? "ok" : "FAILED: " + failure) << "\n";
+    return failure.empty();
+}
+
+static bool runChecks() {
+    bool ok = true;
+    ok &= report("admitBatch vs dequeueViewer", checkBatches());
+    ok &= report("buckets vs heap", checkBuckets());
+    ok &= report("handles, heap mode", checkHandles(QueueMode::Heap, 1));
+    ok &= report("handles, bucket mode", checkHandles(QueueMode::Buckets, 2));
+    ok &= report("stream-slot assignment", checkSlots());
+    // The long runs pass JOURNAL_COMPACT_RECORDS, so the log compacts itself
+    ok &= report("journal restarts, heap mode", checkJournal(QueueMode::Heap, 481, 150000));
+    ok &= report("journal restarts, bucket mode", checkJournal(QueueMode::Buckets, 482, 150000));
+    std::string shortRuns;
+    for (unsigned round = 0; round < 40 && shortRuns.empty(); round++) {
+        shortRuns = checkJournal(round % 2 ? QueueMode::Buckets : QueueMode::Heap, 483 + round, 2000);
+        if (!shortRuns.empty()) shortRuns += " (run " + std::to_string(round) + ")";
+    }
+    ok &= report("journal restarts, 40 short runs", shortRuns);
+    ok &= report("arrival order after replay", checkReplayedArrivals());
+    ok &= report("wait-time percentiles", checkWaitHistogram());
+    ok &= report("IdSet vs std::unordered_set", checkIdSet());
+    ok &= report("duplicate guard, exact", checkGuard(DuplicateGuard::Exact));
+    ok &= report("duplicate guard, Bloom-prefiltered", checkGuard(DuplicateGuard::Prefiltered));
+    ok &= report("guard forgets earlier lines, exact", checkGuardLifetime(DuplicateGuard::Exact));
+    ok &= report("guard forgets earlier lines, Bloom", checkGuardLifetime(DuplicateGuard::Prefiltered));
+    std::cout << (ok ? "All checks passed\n" : "Some checks FAILED\n");
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--stress") {
+        int rounds = argc > 2 ? std::atoi(argv[2]) : 64;
+        return runStress(rounds > 0 ? rounds : 64) ? 0 : 1;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--check") {
+        return runChecks() ? 0 : 1;
+    }
+
+    int viewers = argc > 1 ? std::atoi(argv[1]) : 200000;
+    if (viewers <= 0) viewers = 200000;
+    int waveSize = argc > 2 ? std::atoi(argv[2]) : 100000;
+    if (waveSize <= 0) waveSize = 100000;
+    int structureViewers = argc > 3 ? std::atoi(argv[3]) : 10000000;
+    if (structureViewers <= 0) structureViewers = 10000000;
+    int loadRows = argc > 4 ? std::atoi(argv[4]) : 10000000;
+    if (loadRows <= 0) loadRows = 10000000;
+    int journalRows = argc > 5 ? std::atoi(argv[5]) : 1000000;
+    if (journalRows <= 0) journalRows = 1000000;
+    int guardIDs = argc > 6 ? std::atoi(argv[6]) : 1000000;
+    if (guardIDs <= 0) guardIDs = 1000000;
+    // Each per-record admission waits for an fsync; keep that run short
+    int perRecordViewers = viewers < 5000 ? viewers : 5000;
+
+    std::cout << "Admission log durability. Times in ms: Admit is the admitting loop,\n"
+              << "Total also waits for the log to be committed.\n";
+
+    printHeader("Log writes only");
+    runUnbatchedLog(viewers);
+    runLog(LogDurability::None, viewers);
+    runLog(LogDurability::Batched, viewers);
+    runLog(LogDurability::PerRecord, perRecordViewers);
+
+    printHeader("dequeueViewer");
+    runDequeue(LogDurability::None, viewers);
+    runDequeue(LogDurability::Batched, viewers);
+    runDequeue(LogDurability::PerRecord, perRecordViewers);
+
+    std::cout << "\nAdmission waves (batched log), times in ms\n";
+    std::cout << std::left << std::setw(24) << "Method" << std::right << std::setw(10) << "Queued"
+              << std::setw(10) << "Wave" << std::setw(12) << "Time" << "\n";
+    std::cout << std::string(56, '-') << "\n";
+    int smallWave = waveSize / 100 > 0 ? waveSize / 100 : 1;
+    runWave(viewers, smallWave, false);
+    runWave(viewers, smallWave, true);
+    runWave(viewers, waveSize, false);
+    runWave(viewers, waveSize, true);
+
+    std::cout << "\nQueue structure, no log, times in ms\n";
+    std::cout << std::left << std::setw(24) << "Mode" << std::right << std::setw(10) << "Viewers"
+              << std::setw(12) << "Enqueue" << std::setw(12) << "Dequeue" << std::setw(10) << "Ordered" << "\n";
+    std::cout << std::string(68, '-') << "\n";
+    Viewer** crowd = makeViewers(structureViewers);
+    runStructure(QueueMode::Heap, crowd, structureViewers);
+    runStructure(QueueMode::Buckets, crowd, structureViewers);
+    deleteViewers(crowd, structureViewers);
+
+    std::cout << "\nLoading viewers.csv, times in ms (Same: first admissions match per-row)\n";
+    std::cout << std::left << std::setw(24) << "Loader" << std::right << std::setw(10) << "Viewers"
+              << std::setw(12) << "Load" << std::setw(10) << "Same" << "\n";
+    std::cout << std::string(56, '-') << "\n";
+    runLoad(loadRows);
+
+    std::cout << "\nQueue journal, no fsync, times in ms (Recover: snapshot load + log replay)\n";
+    std::cout << std::left << std::setw(12) << "Mode" << std::right << std::setw(10) << "Viewers"
+              << std::setw(12) << "Logged ops" << std::setw(12) << "Snapshot" << std::setw(12) << "Logging"
+              << std::setw(12) << "Recover" << std::setw(8) << "Same" << "\n";
+    std::cout << std::string(78, '-') << "\n";
+    runJournal(QueueMode::Heap, journalRows);
+    runJournal(QueueMode::Buckets, journalRows);
+
+    std::cout << "\nID membership, build in ms, lookups in ns (Miss: IDs never added)\n";
+    std::cout << std::left << std::setw(24) << "Set" << std::right << std::setw(10) << "IDs"
+              << std::setw(12) << "Build" << std::setw(10) << "Hit" << std::setw(10) << "Miss"
+              << std::setw(10) << "MB" << "\n";
+    std::cout << std::string(76, '-') << "\n";
+    runMembership(guardIDs);
+
+    std::cout << "\nDuplicate guard, times in ms (Startup: restoring a line, which rebuilds its admitted IDs from the log;\n"
+              << "half the arrivals carry admitted IDs)\n";
+    std::cout << std::left << std::setw(20) << "Guard" << std::right << std::setw(10) << "Arrivals"
+              << std::setw(12) << "Startup" << std::setw(12) << "Enqueue" << std::setw(10) << "Rejected"
+              << std::setw(12) << "Admit" << "\n";
+    std::cout << std::string(76, '-') << "\n";
+    runGuard(DuplicateGuard::Off, guardIDs);
+    runGuard(DuplicateGuard::Exact, guardIDs);
+    runGuard(DuplicateGuard::Prefiltered, guardIDs);
+
+    std::cout << "\nStream-slot assignment, dequeueViewer latency in ns (no log, 10 seats per slot)\n";
+    std::cout << std::left << std::setw(24) << "Clock" << std::right << std::setw(10) << "Slots"
+              << std::setw(10) << "Viewers" << std::setw(10) << "Mean" << std::setw(10) << "p50"
+              << std::setw(10) << "p99" << std::setw(12) << "Max" << "\n";
+    std::cout << std::string(86, '-') << "\n";
+    runSlots(0, 10, true);
+    runSlots(10000, 10, true);
+    runSlots(10000, 10, false);
+
+    std::cout << "\nParallel gates, " << std::thread::hardware_concurrency()
+              << " hardware threads, times in ms (Enqueue: until every gate is done)\n";
+    std::cout << std::left << std::setw(16) << "Queue" << std::right << std::setw(10) << "Gates"
+              << std::setw(10) << "Viewers" << std::setw(12) << "Enqueue" << std::setw(14) << "Enqueues/s"
+              << std::setw(12) << "Total" << "\n";
+    std::cout << std::string(74, '-') << "\n";
+    Viewer** gateCrowd = makeViewers(viewers);
+    for (int producers = 1; producers <= 32; producers *= 2) {
+        runGates(producers, gateCrowd, viewers, false);
+        runGates(producers, gateCrowd, viewers, true);
+    }
+    deleteViewers(gateCrowd, viewers);
+
+    std::remove(BENCH_LOG);
+    return 0;
+}
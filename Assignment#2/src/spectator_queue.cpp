@@ -3,63 +3,185 @@
 #include <sstream>
 #include <iostream>
 #include <cstring>
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <ctime>
+#include <cstdio>
+#include <chrono>
+#include <iomanip>
 
 static const int INITIAL_CAPACITY = 16;
 
-SpectatorQueue::SpectatorQueue()
-    : heapSize(0), heapCapacity(INITIAL_CAPACITY), arrivalCounter(0), slotsHead(nullptr), admitLog(nullptr)
+// Logged as the channel when no stream slot has room
+static const std::string UNASSIGNED_CHANNEL = "Unassigned";
+
+// Steady-clock time in nanoseconds, for wait times
+static long long steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static const char* const TIER_NAMES[PRIORITY_TIERS] = {"VIP", "Influencer", "Usual"};
+
+// Lowest set bit of a tier mask, i.e. the best non-empty tier (-1 if none)
+static const int FIRST_TIER[1 << PRIORITY_TIERS] = {-1, 0, 1, 0, 2, 0, 1, 0};
+
+SpectatorQueue::SpectatorQueue(const std::string& logFile, LogDurability durability, QueueMode queueMode,
+                               DuplicateGuard duplicateGuard)
+    : mode(queueMode), heapSize(0), heapCapacity(INITIAL_CAPACITY), arrivalCounter(0),
+      tierMask(0), bucketCount(0), nextTicket(0),
+      handleCapacity(INITIAL_CAPACITY), freeHandle(0),
+      idCapacity(2 * INITIAL_CAPACITY), idCount(0), viewerBlocks(nullptr),
+      slots(nullptr), endPrefixMax(nullptr), nextOpen(nullptr), slotCount(0), admitClock(wallClockMinute),
+      admitLogFile(logFile), guard(duplicateGuard), admittedIDs(duplicateGuard == DuplicateGuard::Prefiltered)
 {
-    heap = new Viewer*[heapCapacity];
+    heap = new HeapEntry[heapCapacity];
+    for (int t = 0; t < PRIORITY_TIERS; t++) {
+        tiers[t].capacity = INITIAL_CAPACITY;
+        tiers[t].items = new TierEntry[INITIAL_CAPACITY];
+        tiers[t].head = 0;
+        tiers[t].count = 0;
+        tiers[t].live = 0;
+    }
+    handles = new HandleSlot[handleCapacity];
+    for (int i = 0; i < handleCapacity; i++) {
+        handles[i].viewer = nullptr;
+        handles[i].nextFree = i + 1 < handleCapacity ? i + 1 : NO_HANDLE;
+    }
+    idTable = new IdIndexEntry[idCapacity];
+    for (int i = 0; i < idCapacity; i++) {
+        idTable[i].handle = NO_HANDLE;
+    }
     // Open admission log in append mode (or create if it doesn't exist)
-    admitLog = std::fopen("data/admitted_viewers.csv", "a");
-    if (!admitLog) {
-        std::perror("Error opening admitted_viewers.csv");
+    if (!logFile.empty() && !admitLog.open(logFile, durability)) {
+        std::perror(("Error opening " + logFile).c_str());
         std::exit(EXIT_FAILURE);
     }
-    // If the file is brand-new (size 0), write header
-    std::fseek(admitLog, 0, SEEK_END);
-    long pos = std::ftell(admitLog);
-    if (pos == 0) {
-        std::fprintf(admitLog, "ViewerID,ViewerName,Priority,AdmitTime,ChannelID\n");
-        std::fflush(admitLog);
-    }
 }
 
 SpectatorQueue::~SpectatorQueue() {
+    // Leave the journal holding the queue for the next start
+    journal.close();
     clearAll();
     delete[] heap;
-    // Free the linked list of slots
-    StreamSlot* cur = slotsHead;
-    while (cur) {
-        StreamSlot* tmp = cur->next;
-        delete cur;
-        cur = tmp;
+    for (int t = 0; t < PRIORITY_TIERS; t++) {
+        delete[] tiers[t].items;
+    }
+    delete[] handles;
+    delete[] idTable;
+    while (viewerBlocks) {
+        ViewerBlock* next = viewerBlocks->next;
+        delete[] viewerBlocks->viewers;
+        delete viewerBlocks;
+        viewerBlocks = next;
     }
-    if (admitLog) std::fclose(admitLog);
+    delete[] slots;
+    delete[] endPrefixMax;
+    delete[] nextOpen;
+    admitLog.close();
 }
 
-void SpectatorQueue::loadViewers(const std::string& filename) {
-    std::ifstream file(filename);
+int SpectatorQueue::loadViewers(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) {
         std::cerr << "Failed to open " << filename << std::endl;
         std::exit(EXIT_FAILURE);
     }
-    std::string line;
+    // Read the whole file, then size the block from the line count
+    std::string text;
+    file.seekg(0, std::ios::end);
+    std::streamoff length = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (length > 0) {
+        text.resize(static_cast<size_t>(length));
+        file.read(&text[0], length);
+    }
+    file.close();
+    int lines = static_cast<int>(std::count(text.begin(), text.end(), '\n')) + 1;
+
     // Skip header row
-    if (!std::getline(file, line)) return;
+    const char* p = text.data();
+    const char* end = p + text.size();
+    const char* headerEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    p = headerEnd ? headerEnd + 1 : end;
 
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        std::string fields[3];
-        parseLine(line, fields, 3);
-        Viewer* v = new Viewer;
-        v->id = fields[0];
-        v->name = fields[1];
-        v->priority = std::stoi(fields[2]);
-        v->arrivalOrder = ++arrivalCounter;
-        enqueueViewer(v);
+    Viewer* viewers = new Viewer[lines];
+    int count = parseViewerRows(p, end, viewers, false);
+    for (int i = 0; i < count; i++) {
+        viewers[i].arrivalOrder = ++arrivalCounter;
     }
-    file.close();
+    ViewerBlock* block = new ViewerBlock;
+    block->viewers = viewers;
+    block->count = count;
+    block->next = viewerBlocks;
+    viewerBlocks = block;
+    int rejected = enqueueBulk(viewers, count);
+
+    // One snapshot instead of a log record per loaded viewer
+    if (journal.isOpen()) {
+        snapshotJournal();
+    }
+    return rejected;
+}
+
+// Splits [p, lineEnd) at commas into at most maxFields fields; returns how many
+static int splitFields(const char* p, const char* lineEnd, const char** starts, const char** ends, int maxFields) {
+    int n = 0;
+    while (n < maxFields) {
+        const char* comma = static_cast<const char*>(std::memchr(p, ',', lineEnd - p));
+        starts[n] = p;
+        ends[n] = comma ? comma : lineEnd;
+        n++;
+        if (!comma) break;
+        p = comma + 1;
+    }
+    return n;
+}
+
+// Integer at the start of [from, to); false if there is none
+static bool parseNumber(const char* from, const char* to, long& value) {
+    char digits[32];
+    size_t length = static_cast<size_t>(to - from);
+    if (length == 0 || length >= sizeof(digits)) return false;
+    std::memcpy(digits, from, length);
+    digits[length] = '\0';
+    char* parsedEnd = nullptr;
+    value = std::strtol(digits, &parsedEnd, 10);
+    return parsedEnd != digits;
+}
+
+int SpectatorQueue::parseViewerRows(const char* p, const char* end, Viewer* viewers, bool withArrival) {
+    int count = 0;
+    int expected = withArrival ? 4 : 3;
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+        const char* next = lineEnd < end ? lineEnd + 1 : end;
+        if (lineEnd > p && lineEnd[-1] == '\r') lineEnd--;
+        if (lineEnd == p) {
+            p = next;
+            continue;
+        }
+        // ViewerID,ViewerName,Priority[,ArrivalOrder]; later fields are ignored
+        const char* starts[4];
+        const char* ends[4];
+        long priority = 0;
+        long arrival = 0;
+        if (splitFields(p, lineEnd, starts, ends, expected) < expected ||
+            !parseNumber(starts[2], ends[2], priority) ||
+            (withArrival && !parseNumber(starts[3], ends[3], arrival))) {
+            std::cerr << "Malformed CSV line: " << std::string(p, lineEnd) << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        Viewer& v = viewers[count++];
+        v.id.assign(starts[0], ends[0]);
+        v.name.assign(starts[1], ends[1]);
+        v.priority = static_cast<int>(priority);
+        v.arrivalOrder = static_cast<int>(arrival);
+        p = next;
+    }
+    return count;
 }
 
 void SpectatorQueue::loadSlots(const std::string& filename) {
@@ -69,76 +191,639 @@ void SpectatorQueue::loadSlots(const std::string& filename) {
         std::exit(EXIT_FAILURE);
     }
     std::string line;
-    // Skip header row
+    // Header row: SlotID,TimeStart,TimeEnd,ChannelID[,Capacity]
     if (!std::getline(file, line)) return;
-    StreamSlot* tail = nullptr;
+    int fieldCount = static_cast<int>(std::count(line.begin(), line.end(), ',')) + 1 >= 5 ? 5 : 4;
 
+    int capacity = slotCount > 0 ? slotCount : INITIAL_CAPACITY;
+    StreamSlot* loaded = new StreamSlot[capacity];
+    int count = 0;
+    for (int i = 0; i < slotCount; i++) {
+        loaded[count++] = slots[i];
+    }
     while (std::getline(file, line)) {
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
         if (line.empty()) continue;
-        std::string fields[4];
-        parseLine(line, fields, 4);
-        StreamSlot* slot = new StreamSlot;
-        slot->slotID = fields[0];
-        slot->timeStart = fields[1];
-        slot->timeEnd = fields[2];
-        slot->channelID = fields[3];
-        slot->next = nullptr;
-
-        if (!slotsHead) {
-            slotsHead = slot;
-            tail = slot;
-        } else {
-            tail->next = slot;
-            tail = slot;
+        std::string fields[5];
+        parseLine(line, fields, fieldCount);
+        if (count == capacity) {
+            capacity *= 2;
+            StreamSlot* bigger = new StreamSlot[capacity];
+            for (int i = 0; i < count; i++) {
+                bigger[i] = loaded[i];
+            }
+            delete[] loaded;
+            loaded = bigger;
         }
+        StreamSlot& slot = loaded[count];
+        slot.slotID = fields[0];
+        slot.timeStart = fields[1];
+        slot.timeEnd = fields[2];
+        slot.channelID = fields[3];
+        slot.capacity = DEFAULT_SLOT_CAPACITY;
+        if (fieldCount == 5) {
+            long slotCapacity = 0;
+            const char* text = fields[4].c_str();
+            if (!parseNumber(text, text + fields[4].size(), slotCapacity) || slotCapacity <= 0 ||
+                slotCapacity > INT_MAX) {
+                std::cerr << "Malformed slot capacity: " << line << std::endl;
+                std::exit(EXIT_FAILURE);
+            }
+            slot.capacity = static_cast<int>(slotCapacity);
+        }
+        slot.assigned = 0;
+        if (!parseSlotTime(slot.timeStart, slot.startMinute) || !parseSlotTime(slot.timeEnd, slot.endMinute)) {
+            std::cerr << "Malformed slot time: " << line << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        count++;
     }
     file.close();
+
+    std::stable_sort(loaded, loaded + count, [](const StreamSlot& a, const StreamSlot& b) {
+        return a.startMinute < b.startMinute;
+    });
+    delete[] slots;
+    delete[] endPrefixMax;
+    delete[] nextOpen;
+    slots = loaded;
+    slotCount = count;
+    endPrefixMax = new long long[count];
+    nextOpen = new int[count + 1];
+    for (int i = 0; i < count; i++) {
+        endPrefixMax[i] = i > 0 && endPrefixMax[i - 1] > slots[i].endMinute ? endPrefixMax[i - 1] : slots[i].endMinute;
+        nextOpen[i] = slots[i].assigned < slots[i].capacity ? i : i + 1;
+    }
+    nextOpen[count] = count;
 }
 
-void SpectatorQueue::enqueueViewer(Viewer* v) {
-    if (heapSize == heapCapacity) {
-        resizeHeap();
+ViewerHandle SpectatorQueue::enqueueViewer(Viewer* v) {
+    if (isDuplicate(v)) return NO_HANDLE;
+    ViewerHandle h = allocateHandle(v);
+    handles[h].enqueuedAt = steadyNanos();
+    indexInsert(h);
+    if (mode == QueueMode::Buckets) {
+        pushTier(tierOf(v), h);
+    } else {
+        if (heapSize == heapCapacity) {
+            resizeHeap();
+        }
+        HeapEntry entry = {keyOf(v), h};
+        place(heapSize, entry);
+        heapSize++;
+        siftUp(heapSize - 1);
+    }
+    if (journal.isOpen()) {
+        journalViewer('E', v);
+        commitJournal();
     }
-    heap[heapSize] = v;
-    siftUp(heapSize);
-    heapSize++;
+    return h;
 }
 
 Viewer* SpectatorQueue::dequeueViewer() {
-    if (heapSize == 0) return nullptr;
-    Viewer* top = heap[0];
-    heapSize--;
-    heap[0] = heap[heapSize];
-    siftDown(0);
-
-    // Log admission (placeholder admit time & channel)
-    std::string admitTime = "2025-06-15T00:00";  // Replace with real timestamp if desired
-    std::fprintf(admitLog, "%s,%s,%d,%s,%s\n",
-                 top->id.c_str(), top->name.c_str(), top->priority,
-                 admitTime.c_str(), "ChannelX");
-    std::fflush(admitLog);
+    if (isEmpty()) return nullptr;
+    ViewerHandle h = mode == QueueMode::Buckets ? popBucket() : removeHeapAt(0);
+    Viewer* top = admitHandle(h, steadyNanos());
+
+    // Log admission with the stream slot that takes the viewer
+    long long minute = admitClock();
+    StreamSlot* slot = assignSlot(minute);
+    admitLog.append(top->id, top->name, top->priority, formatSlotTime(minute),
+                    slot ? slot->channelID : UNASSIGNED_CHANNEL);
+    if (journal.isOpen()) {
+        journalViewer('D', top);
+        commitJournal();
+    }
     return top;
 }
 
+int SpectatorQueue::admitBatch(int n, Viewer** out) {
+    if (n > size()) n = size();
+    if (n <= 0) return 0;
+
+    int levels = 1;
+    while ((1 << levels) <= heapSize) levels++;
+    long long now = steadyNanos();
+    if (mode == QueueMode::Buckets) {
+        for (int i = 0; i < n; i++) {
+            out[i] = admitHandle(popBucket(), now);
+        }
+    } else if (static_cast<long long>(n) * levels < heapSize) {
+        // Small wave: n pops cost less than touching the whole heap
+        for (int i = 0; i < n; i++) {
+            out[i] = admitHandle(removeHeapAt(0), now);
+        }
+    } else {
+        // Large wave: select the top n in O(size), sort only those, then
+        // rebuild the heap from the rest
+        auto first = [](const HeapEntry& a, const HeapEntry& b) { return a.key < b.key; };
+        if (n < heapSize) std::nth_element(heap, heap + n, heap + heapSize, first);
+        std::sort(heap, heap + n, first);
+        for (int i = 0; i < n; i++) {
+            out[i] = admitHandle(heap[i].handle, now);
+        }
+        heapSize -= n;
+        for (int i = 0; i < heapSize; i++) {
+            place(i, heap[i + n]);
+        }
+        heapify();
+    }
+
+    // The whole wave is admitted at one time; each viewer still takes a seat
+    // in the first slot with room, spilling into later slots
+    long long minute = admitClock();
+    const std::string** channels = new const std::string*[n];
+    for (int i = 0; i < n; i++) {
+        StreamSlot* slot = assignSlot(minute);
+        channels[i] = slot ? &slot->channelID : &UNASSIGNED_CHANNEL;
+    }
+    admitLog.appendBatch(out, channels, n, formatSlotTime(minute));
+    delete[] channels;
+    if (journal.isOpen()) {
+        for (int i = 0; i < n; i++) {
+            journalViewer('D', out[i]);
+        }
+        commitJournal();
+    }
+    return n;
+}
+
+ViewerHandle SpectatorQueue::findViewer(const std::string& id) const {
+    unsigned hash = hashID(id);
+    for (int i = hash & (idCapacity - 1); idTable[i].handle != NO_HANDLE; i = (i + 1) & (idCapacity - 1)) {
+        if (idTable[i].hash == hash && handles[idTable[i].handle].viewer->id == id) {
+            return idTable[i].handle;
+        }
+    }
+    return NO_HANDLE;
+}
+
+ViewerHandle SpectatorQueue::findQueued(const std::string& id, int arrivalOrder) const {
+    unsigned hash = hashID(id);
+    for (int i = hash & (idCapacity - 1); idTable[i].handle != NO_HANDLE; i = (i + 1) & (idCapacity - 1)) {
+        const Viewer* v = handles[idTable[i].handle].viewer;
+        if (idTable[i].hash == hash && v->arrivalOrder == arrivalOrder && v->id == id) {
+            return idTable[i].handle;
+        }
+    }
+    // The index only keeps the latest viewer per ID; earlier duplicates need a scan
+    for (int h = 0; h < handleCapacity; h++) {
+        const Viewer* v = handles[h].viewer;
+        if (v != nullptr && v->arrivalOrder == arrivalOrder && v->id == id) return h;
+    }
+    return NO_HANDLE;
+}
+
+bool SpectatorQueue::changePriority(ViewerHandle h, int newPriority) {
+    if (!isQueued(h)) return false;
+    Viewer* v = handles[h].viewer;
+    if (mode == QueueMode::Buckets) {
+        int oldTier = tierOf(v);
+        v->priority = newPriority;
+        if (tierOf(v) != oldTier) {
+            pushTier(tierOf(v), h);   // The old entry is now a tombstone
+            dropFromTier(oldTier);
+        }
+    } else {
+        v->priority = newPriority;
+        int idx = handles[h].position;
+        long long oldKey = heap[idx].key;
+        heap[idx].key = keyOf(v);
+        if (heap[idx].key < oldKey) {
+            siftUp(idx);
+        } else {
+            siftDown(idx);
+        }
+    }
+    if (journal.isOpen()) {
+        journalViewer('P', v);
+        commitJournal();
+    }
+    return true;
+}
+
+Viewer* SpectatorQueue::removeViewer(ViewerHandle h) {
+    if (!isQueued(h)) return nullptr;
+    Viewer* v;
+    if (mode == QueueMode::Buckets) {
+        v = releaseHandle(h);   // Its ring entry is now a tombstone
+        dropFromTier(tierOf(v));
+    } else {
+        removeHeapAt(handles[h].position);
+        v = releaseHandle(h);
+    }
+    if (journal.isOpen()) {
+        journalViewer('R', v);
+        commitJournal();
+    }
+    return v;
+}
+
 bool SpectatorQueue::isEmpty() const {
-    return heapSize == 0;
+    return size() == 0;
 }
 
 int SpectatorQueue::size() const {
-    return heapSize;
+    return mode == QueueMode::Buckets ? bucketCount : heapSize;
+}
+
+void SpectatorQueue::releaseViewer(Viewer* v) {
+    if (!v) return;
+    if (inViewerBlock(v)) {
+        // Give back the strings now; the block goes with the queue
+        std::string().swap(v->id);
+        std::string().swap(v->name);
+    } else {
+        delete v;
+    }
 }
 
 void SpectatorQueue::clearAll() {
-    // Delete all remaining Viewer* in the heap
-    for (int i = 0; i < heapSize; i++) {
-        delete heap[i];
+    // Free every queued Viewer*, whichever structure holds it
+    for (int i = 0; i < handleCapacity; i++) {
+        releaseViewer(handles[i].viewer);
+        handles[i].viewer = nullptr;
+        handles[i].nextFree = i + 1 < handleCapacity ? i + 1 : NO_HANDLE;
     }
+    freeHandle = 0;
     heapSize = 0;
+    for (int t = 0; t < PRIORITY_TIERS; t++) {
+        tiers[t].head = 0;
+        tiers[t].count = 0;
+        tiers[t].live = 0;
+    }
+    tierMask = 0;
+    bucketCount = 0;
+    for (int i = 0; i < idCapacity; i++) {
+        idTable[i].handle = NO_HANDLE;
+    }
+    idCount = 0;
+    if (journal.isOpen()) {
+        journalRecords += "C\n";
+        commitJournal();
+    }
+}
+
+bool SpectatorQueue::inViewerBlock(const Viewer* v) const {
+    std::less<const Viewer*> before;
+    for (ViewerBlock* block = viewerBlocks; block; block = block->next) {
+        if (!before(v, block->viewers) && before(v, block->viewers + block->count)) return true;
+    }
+    return false;
+}
+
+void SpectatorQueue::reserve(int extra) {
+    int needed = size() + extra;
+    if (mode == QueueMode::Heap && needed > heapCapacity) {
+        HeapEntry* newArr = new HeapEntry[needed];
+        for (int i = 0; i < heapSize; i++) {
+            newArr[i] = heap[i];
+        }
+        delete[] heap;
+        heap = newArr;
+        heapCapacity = needed;
+    }
+    // Every handle in use belongs to a queued viewer
+    if (needed > handleCapacity) {
+        HandleSlot* newSlots = new HandleSlot[needed];
+        for (int i = 0; i < handleCapacity; i++) {
+            newSlots[i] = handles[i];
+        }
+        // New slots go on the front of the free list
+        for (int i = handleCapacity; i < needed; i++) {
+            newSlots[i].viewer = nullptr;
+            newSlots[i].nextFree = i + 1 < needed ? i + 1 : freeHandle;
+        }
+        freeHandle = handleCapacity;
+        delete[] handles;
+        handles = newSlots;
+        handleCapacity = needed;
+    }
+    while (2 * (idCount + extra) > idCapacity) {
+        growIndex();
+    }
+}
+
+int SpectatorQueue::enqueueBulk(Viewer* viewers, int count) {
+    reserve(count);
+    long long now = steadyNanos();
+    int rejected = 0;
+    for (int i = 0; i < count; i++) {
+        Viewer* v = &viewers[i];
+        if (isDuplicate(v)) {
+            releaseViewer(v);
+            rejected++;
+            continue;
+        }
+        ViewerHandle h = allocateHandle(v);
+        handles[h].enqueuedAt = now;
+        indexInsert(h);
+        if (mode == QueueMode::Buckets) {
+            pushTier(tierOf(v), h);
+        } else {
+            HeapEntry entry = {keyOf(v), h};
+            place(heapSize++, entry);
+        }
+    }
+    if (mode == QueueMode::Heap) {
+        heapify();
+    }
+    return rejected;
+}
+
+Viewer* SpectatorQueue::admitHandle(ViewerHandle h, long long now) {
+    long long waited = now - handles[h].enqueuedAt;
+    Viewer* v = releaseHandle(h);
+    waits[tierOf(v)].record(waited);
+    if (guard != DuplicateGuard::Off) {
+        admittedIDs.insert(v->id);
+    }
+    return v;
+}
+
+bool SpectatorQueue::isDuplicate(const Viewer* v) const {
+    if (guard == DuplicateGuard::Off) return false;
+    return findViewer(v->id) != NO_HANDLE || admittedIDs.contains(v->id);
+}
+
+// Size in bytes of filename, or 0 if it cannot be opened
+static long long fileSize(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return 0;
+    file.seekg(0, std::ios::end);
+    return static_cast<long long>(file.tellg());
+}
+
+void SpectatorQueue::loadAdmittedIDs(long long from) {
+    std::ifstream file(admitLogFile, std::ios::binary);
+    if (!file.is_open()) return;    // No admissions yet
+    std::string text;
+    file.seekg(0, std::ios::end);
+    std::streamoff length = file.tellg();
+    // A log shorter than from was replaced since the line began; all of it
+    // is then the line's
+    if (from > length) from = 0;
+    file.seekg(from, std::ios::beg);
+    if (length > from) {
+        text.resize(static_cast<size_t>(length - from));
+        file.read(&text[0], length - from);
+    }
+    // The ViewerID column of every row, skipping the header at the start of the file
+    const char* p = text.data();
+    const char* end = p + text.size();
+    bool header = from == 0;
+    std::string id;
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+        const char* comma = static_cast<const char*>(std::memchr(p, ',', lineEnd - p));
+        if (!header && comma && comma > p) {
+            id.assign(p, comma);
+            admittedIDs.insert(id);
+        }
+        header = false;
+        p = lineEnd < end ? lineEnd + 1 : end;
+    }
+}
+
+// Wait in the largest unit that keeps it at 1 or more
+static std::string formatWait(long long nanoseconds) {
+    static const char* const UNITS[] = {"ns", "us", "ms", "s"};
+    double value = static_cast<double>(nanoseconds);
+    int unit = 0;
+    while (unit < 3 && value >= 1000.0) {
+        value /= 1000.0;
+        unit++;
+    }
+    if (unit == 3 && value >= 60.0) {
+        value /= 60.0;
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.1f min", value);
+        return text;
+    }
+    char text[32];
+    std::snprintf(text, sizeof(text), unit == 0 ? "%.0f %s" : "%.2f %s", value, UNITS[unit]);
+    return text;
+}
+
+void SpectatorQueue::printWaitTimes(std::ostream& out) const {
+    out << std::left << std::setw(12) << "Tier" << std::right << std::setw(10) << "Admitted"
+        << std::setw(12) << "p50" << std::setw(12) << "p90" << std::setw(12) << "p99"
+        << std::setw(12) << "Max" << "\n";
+    for (int t = 0; t < PRIORITY_TIERS; t++) {
+        const WaitHistogram& w = waits[t];
+        out << std::left << std::setw(12) << TIER_NAMES[t] << std::right << std::setw(10) << w.count();
+        if (w.count() == 0) {
+            out << std::setw(12) << "-" << std::setw(12) << "-" << std::setw(12) << "-" << std::setw(12) << "-";
+        } else {
+            out << std::setw(12) << formatWait(w.percentile(50)) << std::setw(12) << formatWait(w.percentile(90))
+                << std::setw(12) << formatWait(w.percentile(99)) << std::setw(12) << formatWait(w.max());
+        }
+        out << "\n";
+    }
+}
+
+void SpectatorQueue::dumpWaitTimes(std::ostream& out) const {
+    out << "Tier,Admitted,MinNs,P50Ns,P90Ns,P99Ns,MaxNs,MeanNs\n";
+    for (int t = 0; t < PRIORITY_TIERS; t++) {
+        const WaitHistogram& w = waits[t];
+        out << TIER_NAMES[t] << "," << w.count() << "," << w.min() << "," << w.percentile(50) << ","
+            << w.percentile(90) << "," << w.percentile(99) << "," << w.max() << ","
+            << static_cast<long long>(w.mean()) << "\n";
+    }
+}
+
+void SpectatorQueue::flushAdmissionLog() {
+    admitLog.flush();
+}
+
+bool SpectatorQueue::openJournal(const std::string& journalBase, LogDurability durability) {
+    std::string rows;
+    std::string log;
+    int rowCount = 0;
+    int savedCounter = 0;
+    long long admitStart = 0;
+    bool restored = journal.read(journalBase, rows, rowCount, savedCounter, admitStart, log);
+    if (restored && guard != DuplicateGuard::Off) {
+        // The line's admissions, including any whose D record did not reach
+        // the journal before the crash
+        loadAdmittedIDs(admitStart);
+    } else if (!restored) {
+        // A new line: admissions already in the log belong to earlier ones
+        flushAdmissionLog();
+        admitStart = admitLogFile.empty() ? 0 : fileSize(admitLogFile);
+    }
+    if (restored) {
+        // The snapshot is in admission order, so the heap rebuild moves nothing
+        Viewer* viewers = new Viewer[rowCount];
+        if (parseViewerRows(rows.data(), rows.data() + rows.size(), viewers, true) != rowCount) {
+            std::cerr << "Corrupt snapshot for " << journalBase << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        ViewerBlock* block = new ViewerBlock;
+        block->viewers = viewers;
+        block->count = rowCount;
+        block->next = viewerBlocks;
+        viewerBlocks = block;
+        enqueueBulk(viewers, rowCount);
+        if (savedCounter > arrivalCounter) arrivalCounter = savedCounter;
+        replayJournal(log);
+    }
+    if (!journal.open(journalBase, durability, admitStart)) {
+        std::perror(("Error opening " + journalBase + ".oplog").c_str());
+        std::exit(EXIT_FAILURE);
+    }
+    return restored;
+}
+
+void SpectatorQueue::snapshotJournal() {
+    if (!journal.isOpen()) return;
+    // Rows go out in admission order, so either mode restores the same line
+    std::string rows;
+    int count = 0;
+    auto addRow = [&](const Viewer* v) {
+        rows += v->id;
+        rows += ',';
+        rows += v->name;
+        rows += ',';
+        rows += std::to_string(v->priority);
+        rows += ',';
+        rows += std::to_string(v->arrivalOrder);
+        rows += '\n';
+        count++;
+    };
+    if (mode == QueueMode::Buckets) {
+        for (int t = 0; t < PRIORITY_TIERS; t++) {
+            const ViewerRing& ring = tiers[t];
+            for (int i = 0; i < ring.count; i++) {
+                TierEntry entry = ring.items[(ring.head + i) & (ring.capacity - 1)];
+                const HandleSlot& slot = handles[entry.handle];
+                if (slot.viewer != nullptr && slot.ticket == entry.ticket) {
+                    addRow(slot.viewer);
+                }
+            }
+        }
+    } else {
+        HeapEntry* order = new HeapEntry[heapSize > 0 ? heapSize : 1];
+        std::copy(heap, heap + heapSize, order);
+        std::sort(order, order + heapSize, [](const HeapEntry& a, const HeapEntry& b) { return a.key < b.key; });
+        for (int i = 0; i < heapSize; i++) {
+            addRow(handles[order[i].handle].viewer);
+        }
+        delete[] order;
+    }
+    journal.writeSnapshot(rows, count, arrivalCounter);
+}
+
+void SpectatorQueue::flushJournal() {
+    journal.flush();
+}
+
+void SpectatorQueue::discardJournal() {
+    journal.discard();
+    // The guard's memory of admissions ends with the line
+    admittedIDs.clear();
+}
+
+void SpectatorQueue::journalViewer(char op, const Viewer* v) {
+    journalRecords += op;
+    journalRecords += ',';
+    journalRecords += v->id;
+    if (op == 'E') {
+        journalRecords += ',';
+        journalRecords += v->name;
+        journalRecords += ',';
+        journalRecords += std::to_string(v->priority);
+    }
+    journalRecords += ',';
+    journalRecords += std::to_string(v->arrivalOrder);
+    if (op == 'P') {
+        journalRecords += ',';
+        journalRecords += std::to_string(v->priority);
+    }
+    journalRecords += '\n';
+}
+
+void SpectatorQueue::commitJournal() {
+    journal.append(journalRecords);
+    journalRecords.clear();
+    // Compact once the log outgrows the queue, so replay stays O(queue size)
+    long long logged = journal.recordsSinceSnapshot();
+    if (logged >= JOURNAL_COMPACT_RECORDS && logged > size()) {
+        snapshotJournal();
+    }
+}
+
+void SpectatorQueue::replayJournal(const std::string& log) {
+    const char* p = log.data();
+    const char* end = p + log.size();
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+        const char* starts[5];
+        const char* ends[5];
+        int fields = splitFields(p, lineEnd, starts, ends, 5);
+        char op = ends[0] - starts[0] == 1 ? *starts[0] : '?';
+        long arrival = 0;
+        long priority = 0;
+        bool valid;
+        switch (op) {
+            case 'E':   // E,ViewerID,ViewerName,Priority,ArrivalOrder
+                valid = fields == 5 && parseNumber(starts[3], ends[3], priority) &&
+                        parseNumber(starts[4], ends[4], arrival);
+                break;
+            case 'D':   // D,ViewerID,ArrivalOrder: admitted
+            case 'R':   // R,ViewerID,ArrivalOrder: left the line
+                valid = fields == 3 && parseNumber(starts[2], ends[2], arrival);
+                break;
+            case 'P':   // P,ViewerID,ArrivalOrder,Priority
+                valid = fields == 4 && parseNumber(starts[2], ends[2], arrival) &&
+                        parseNumber(starts[3], ends[3], priority);
+                break;
+            case 'C':   // C: queue cleared
+                valid = fields == 1;
+                break;
+            default:
+                valid = false;
+        }
+        if (!valid) {
+            std::cerr << "Malformed journal record: " << std::string(p, lineEnd) << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+
+        if (op == 'E') {
+            Viewer* v = new Viewer;
+            v->id.assign(starts[1], ends[1]);
+            v->name.assign(starts[2], ends[2]);
+            v->priority = static_cast<int>(priority);
+            v->arrivalOrder = static_cast<int>(arrival);
+            // Later loads must number after every replayed arrival, even one
+            // admitted before the crash
+            if (v->arrivalOrder > arrivalCounter) arrivalCounter = v->arrivalOrder;
+            if (enqueueViewer(v) == NO_HANDLE) {
+                delete v;   // Admitted after the snapshot, before the crash
+            }
+        } else if (op == 'C') {
+            clearAll();
+        } else {
+            // A viewer the record no longer matches is skipped
+            ViewerHandle h = findQueued(std::string(starts[1], ends[1]), static_cast<int>(arrival));
+            if (op == 'P') {
+                changePriority(h, static_cast<int>(priority));
+            } else {
+                releaseViewer(removeViewer(h));
+            }
+            if (op == 'D' && guard != DuplicateGuard::Off) {
+                admittedIDs.insert(std::string(starts[1], ends[1]));
+            }
+        }
+        p = lineEnd + 1;
+    }
 }
 
 void SpectatorQueue::resizeHeap() {
     int newCap = heapCapacity * 2;
-    Viewer** newArr = new Viewer*[newCap];
+    HeapEntry* newArr = new HeapEntry[newCap];
     for (int i = 0; i < heapSize; i++) {
         newArr[i] = heap[i];
     }
@@ -147,46 +832,347 @@ void SpectatorQueue::resizeHeap() {
     heapCapacity = newCap;
 }
 
+// Both sifts move a hole instead of swapping, writing each moved entry once
 void SpectatorQueue::siftUp(int idx) {
+    HeapEntry entry = heap[idx];
     while (idx > 0) {
         int parent = (idx - 1) / 2;
-        if (compare(heap[idx], heap[parent]) > 0) {
-            std::swap(heap[idx], heap[parent]);
+        if (entry.key < heap[parent].key) {
+            place(idx, heap[parent]);
             idx = parent;
         } else {
             break;
         }
     }
+    place(idx, entry);
 }
 
 void SpectatorQueue::siftDown(int idx) {
+    HeapEntry entry = heap[idx];
     while (true) {
         int left = 2 * idx + 1;
-        int right = 2 * idx + 2;
-        int largest = idx;
-        if (left < heapSize && compare(heap[left], heap[largest]) > 0) {
-            largest = left;
-        }
-        if (right < heapSize && compare(heap[right], heap[largest]) > 0) {
-            largest = right;
+        if (left >= heapSize) break;
+        int right = left + 1;
+        int first = left;
+        if (right < heapSize && heap[right].key < heap[left].key) {
+            first = right;
         }
-        if (largest != idx) {
-            std::swap(heap[idx], heap[largest]);
-            idx = largest;
+        if (heap[first].key < entry.key) {
+            place(idx, heap[first]);
+            idx = first;
         } else {
             break;
         }
     }
+    place(idx, entry);
+}
+
+void SpectatorQueue::heapify() {
+    for (int i = heapSize / 2 - 1; i >= 0; i--) {
+        siftDown(i);
+    }
+}
+
+void SpectatorQueue::place(int idx, const HeapEntry& entry) {
+    heap[idx] = entry;
+    handles[entry.handle].position = idx;
+}
+
+long long SpectatorQueue::keyOf(const Viewer* v) {
+    // Lower `priority` value = higher actual priority (1 is highest), then
+    // lower arrivalOrder = earlier
+    return static_cast<long long>(v->priority) * 4294967296LL +
+           (static_cast<long long>(v->arrivalOrder) - INT_MIN);
+}
+
+ViewerHandle SpectatorQueue::removeHeapAt(int idx) {
+    ViewerHandle h = heap[idx].handle;
+    heapSize--;
+    if (idx < heapSize) {
+        place(idx, heap[heapSize]);
+        if (idx > 0 && heap[idx].key < heap[(idx - 1) / 2].key) {
+            siftUp(idx);
+        } else {
+            siftDown(idx);
+        }
+    }
+    return h;
+}
+
+int SpectatorQueue::tierOf(const Viewer* v) {
+    if (v->priority < 1) return 0;
+    if (v->priority > PRIORITY_TIERS) return PRIORITY_TIERS - 1;
+    return v->priority - 1;
+}
+
+void SpectatorQueue::pushTier(int tier, ViewerHandle h) {
+    ViewerRing& ring = tiers[tier];
+    if (ring.count == ring.capacity) {
+        // Unwrap into an array twice the size
+        int newCap = ring.capacity * 2;
+        TierEntry* newItems = new TierEntry[newCap];
+        for (int i = 0; i < ring.count; i++) {
+            newItems[i] = ring.items[(ring.head + i) & (ring.capacity - 1)];
+        }
+        delete[] ring.items;
+        ring.items = newItems;
+        ring.capacity = newCap;
+        ring.head = 0;
+    }
+    TierEntry entry = {h, nextTicket++};
+    handles[h].ticket = entry.ticket;
+    ring.items[(ring.head + ring.count) & (ring.capacity - 1)] = entry;
+    ring.count++;
+    ring.live++;
+    tierMask |= 1u << tier;
+    bucketCount++;
+}
+
+ViewerHandle SpectatorQueue::popBucket() {
+    while (true) {
+        int tier = FIRST_TIER[tierMask];
+        ViewerRing& ring = tiers[tier];
+        TierEntry entry = ring.items[ring.head];
+        ring.head = (ring.head + 1) & (ring.capacity - 1);
+        ring.count--;
+        const HandleSlot& slot = handles[entry.handle];
+        if (slot.viewer == nullptr || slot.ticket != entry.ticket) {
+            continue;   // Tombstone
+        }
+        if (--ring.live == 0) {
+            ring.head = 0;
+            ring.count = 0;
+            tierMask &= ~(1u << tier);
+        }
+        bucketCount--;
+        return entry.handle;
+    }
+}
+
+void SpectatorQueue::dropFromTier(int tier) {
+    ViewerRing& ring = tiers[tier];
+    ring.live--;
+    bucketCount--;
+    if (ring.live == 0) {
+        // Only tombstones left
+        ring.head = 0;
+        ring.count = 0;
+        tierMask &= ~(1u << tier);
+    } else if (ring.count > 2 * ring.live + INITIAL_CAPACITY) {
+        // Mostly tombstones: copy the live entries down, O(1) amortized
+        int kept = 0;
+        TierEntry* newItems = new TierEntry[ring.capacity];
+        for (int i = 0; i < ring.count; i++) {
+            TierEntry entry = ring.items[(ring.head + i) & (ring.capacity - 1)];
+            const HandleSlot& slot = handles[entry.handle];
+            if (slot.viewer != nullptr && slot.ticket == entry.ticket) {
+                newItems[kept++] = entry;
+            }
+        }
+        delete[] ring.items;
+        ring.items = newItems;
+        ring.head = 0;
+        ring.count = kept;
+    }
+}
+
+ViewerHandle SpectatorQueue::allocateHandle(Viewer* v) {
+    if (freeHandle == NO_HANDLE) {
+        int newCap = handleCapacity * 2;
+        HandleSlot* newSlots = new HandleSlot[newCap];
+        for (int i = 0; i < handleCapacity; i++) {
+            newSlots[i] = handles[i];
+        }
+        for (int i = handleCapacity; i < newCap; i++) {
+            newSlots[i].viewer = nullptr;
+            newSlots[i].nextFree = i + 1 < newCap ? i + 1 : NO_HANDLE;
+        }
+        delete[] handles;
+        handles = newSlots;
+        freeHandle = handleCapacity;
+        handleCapacity = newCap;
+    }
+    ViewerHandle h = freeHandle;
+    freeHandle = handles[h].nextFree;
+    handles[h].viewer = v;
+    return h;
+}
+
+Viewer* SpectatorQueue::releaseHandle(ViewerHandle h) {
+    indexErase(h);
+    Viewer* v = handles[h].viewer;
+    handles[h].viewer = nullptr;
+    handles[h].nextFree = freeHandle;
+    freeHandle = h;
+    return v;
+}
+
+bool SpectatorQueue::isQueued(ViewerHandle h) const {
+    return h >= 0 && h < handleCapacity && handles[h].viewer != nullptr;
+}
+
+unsigned SpectatorQueue::hashID(const std::string& id) {
+    // FNV-1a
+    unsigned hash = 2166136261u;
+    for (size_t i = 0; i < id.size(); i++) {
+        hash = (hash ^ static_cast<unsigned char>(id[i])) * 16777619u;
+    }
+    return hash;
+}
+
+void SpectatorQueue::indexInsert(ViewerHandle h) {
+    if (2 * (idCount + 1) > idCapacity) {
+        growIndex();
+    }
+    const std::string& id = handles[h].viewer->id;
+    unsigned hash = hashID(id);
+    int i = hash & (idCapacity - 1);
+    while (idTable[i].handle != NO_HANDLE) {
+        if (idTable[i].hash == hash && handles[idTable[i].handle].viewer->id == id) {
+            idTable[i].handle = h;  // Duplicate ID: the latest viewer wins
+            return;
+        }
+        i = (i + 1) & (idCapacity - 1);
+    }
+    idTable[i].handle = h;
+    idTable[i].hash = hash;
+    idCount++;
+}
+
+void SpectatorQueue::indexErase(ViewerHandle h) {
+    int mask = idCapacity - 1;
+    unsigned hash = hashID(handles[h].viewer->id);
+    int i = hash & mask;
+    while (idTable[i].handle != h) {
+        if (idTable[i].handle == NO_HANDLE) return;  // Shadowed by a later duplicate
+        i = (i + 1) & mask;
+    }
+    // Backward-shift deletion: pull later entries of the probe run into the gap
+    int j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        if (idTable[j].handle == NO_HANDLE) break;
+        int home = idTable[j].hash & mask;
+        bool stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (!stays) {
+            idTable[i] = idTable[j];
+            i = j;
+        }
+    }
+    idTable[i].handle = NO_HANDLE;
+    idCount--;
+}
+
+void SpectatorQueue::growIndex() {
+    int oldCap = idCapacity;
+    IdIndexEntry* oldTable = idTable;
+    idCapacity = oldCap * 2;
+    idTable = new IdIndexEntry[idCapacity];
+    for (int i = 0; i < idCapacity; i++) {
+        idTable[i].handle = NO_HANDLE;
+    }
+    for (int i = 0; i < oldCap; i++) {
+        if (oldTable[i].handle == NO_HANDLE) continue;
+        int j = oldTable[i].hash & (idCapacity - 1);
+        while (idTable[j].handle != NO_HANDLE) {
+            j = (j + 1) & (idCapacity - 1);
+        }
+        idTable[j] = oldTable[i];
+    }
+    delete[] oldTable;
+}
+
+StreamSlot* SpectatorQueue::assignSlot(long long minute) {
+    if (slotCount == 0) return nullptr;
+    // First slot whose running maximum end is after minute: every slot
+    // before it has already ended
+    int low = 0, high = slotCount;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (endPrefixMax[mid] > minute) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    // Skip full slots, and the rare slot nested inside a longer one that has ended
+    int i = findOpenSlot(low);
+    while (i < slotCount && slots[i].endMinute <= minute) {
+        i = findOpenSlot(i + 1);
+    }
+    if (i == slotCount) return nullptr;
+    // A slot that has not started only takes the viewer when slots are running
+    // at minute and all of them are full. Slot low is the first not ended, so
+    // some slot is running exactly when slot low has started.
+    if (slots[i].startMinute > minute && slots[low].startMinute > minute) return nullptr;
+
+    StreamSlot& slot = slots[i];
+    if (++slot.assigned == slot.capacity) {
+        nextOpen[i] = i + 1;
+    }
+    return &slot;
+}
+
+int SpectatorQueue::findOpenSlot(int i) {
+    while (nextOpen[i] != i) {
+        nextOpen[i] = nextOpen[nextOpen[i]];
+        i = nextOpen[i];
+    }
+    return i;
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant's algorithm)
+static long long daysFromCivil(long long y, int m, int d) {
+    y -= m <= 2;
+    long long era = (y >= 0 ? y : y - 399) / 400;
+    long long yoe = y - era * 400;
+    long long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static void civilFromDays(long long z, long long& y, int& m, int& d) {
+    z += 719468;
+    long long era = (z >= 0 ? z : z - 146096) / 146097;
+    long long doe = z - era * 146097;
+    long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long long mp = (5 * doy + 2) / 153;
+    d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    y = yoe + era * 400 + (m <= 2);
+}
+
+long long wallClockMinute() {
+    std::time_t now = std::time(nullptr);
+    std::tm local = *std::localtime(&now);
+    return daysFromCivil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday) * 1440 +
+           local.tm_hour * 60 + local.tm_min;
+}
+
+bool parseSlotTime(const std::string& text, long long& minute) {
+    int year, month, day, hour, min;
+    char extra;
+    if (std::sscanf(text.c_str(), "%d-%d-%dT%d:%d%c", &year, &month, &day, &hour, &min, &extra) != 5) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour < 0 || hour > 23 || min < 0 || min > 59) {
+        return false;
+    }
+    minute = daysFromCivil(year, month, day) * 1440 + hour * 60 + min;
+    return true;
 }
 
-int SpectatorQueue::compare(Viewer* a, Viewer* b) const {
-    // Lower `priority` value = higher actual priority (1 is highest)
-    if (a->priority < b->priority) return 1;
-    if (a->priority > b->priority) return -1;
-    // Tie-break by arrivalOrder (lower = earlier)
-    if (a->arrivalOrder < b->arrivalOrder) return 1;
-    if (a->arrivalOrder > b->arrivalOrder) return -1;
-    return 0;
+std::string formatSlotTime(long long minute) {
+    long long days = minute >= 0 ? minute / 1440 : -((-minute + 1439) / 1440);
+    int minuteOfDay = static_cast<int>(minute - days * 1440);
+    long long year;
+    int month, day;
+    civilFromDays(days, year, month, day);
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%04lld-%02d-%02dT%02d:%02d",
+                  year, month, day, minuteOfDay / 60, minuteOfDay % 60);
+    return buffer;
 }
 
 void SpectatorQueue::parseLine(const std::string& line, std::string* fields, int expectedFields) {
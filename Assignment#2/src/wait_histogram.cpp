@@ -0,0 +1,69 @@
+#include "wait_histogram.hpp"
+#include <climits>
+#include <cmath>
+
+// Index of the highest set bit; value must not be 0
+static int highestBit(unsigned long long value) {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(value);
+#else
+    int bit = 0;
+    while (value >>= 1) bit++;
+    return bit;
+#endif
+}
+
+WaitHistogram::WaitHistogram() {
+    clear();
+}
+
+void WaitHistogram::clear() {
+    for (int i = 0; i < BUCKETS; i++) {
+        counts[i] = 0;
+    }
+    total = 0;
+    minValue = LLONG_MAX;
+    maxValue = 0;
+    sum = 0.0;
+}
+
+void WaitHistogram::record(long long nanoseconds) {
+    if (nanoseconds < 0) nanoseconds = 0;
+    counts[bucketOf(nanoseconds)]++;
+    total++;
+    if (nanoseconds < minValue) minValue = nanoseconds;
+    if (nanoseconds > maxValue) maxValue = nanoseconds;
+    sum += static_cast<double>(nanoseconds);
+}
+
+long long WaitHistogram::percentile(double percent) const {
+    if (total == 0) return 0;
+    long long target = static_cast<long long>(std::ceil(percent / 100.0 * total));
+    if (target < 1) target = 1;
+    if (target >= total) return maxValue;
+    long long seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += counts[i];
+        if (seen >= target) {
+            long long highest = highestIn(i);
+            return highest < maxValue ? highest : maxValue;
+        }
+    }
+    return maxValue;
+}
+
+int WaitHistogram::bucketOf(long long value) {
+    // Exact below 2 * SUB_BUCKETS; above, the top SUB_BUCKET_BITS + 1 bits
+    // pick the bucket within the value's power of two
+    if (value < 2 * SUB_BUCKETS) return static_cast<int>(value);
+    int shift = highestBit(static_cast<unsigned long long>(value)) - SUB_BUCKET_BITS;
+    return shift * SUB_BUCKETS + static_cast<int>(value >> shift);
+}
+
+long long WaitHistogram::highestIn(int bucket) {
+    if (bucket < 2 * SUB_BUCKETS) return bucket;
+    int shift = bucket / SUB_BUCKETS - 1;
+    unsigned long long sub = bucket % SUB_BUCKETS + SUB_BUCKETS;
+    unsigned long long highest = ((sub + 1) << shift) - 1;
+    return highest > static_cast<unsigned long long>(LLONG_MAX) ? LLONG_MAX : static_cast<long long>(highest);
+}